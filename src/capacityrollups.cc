@@ -0,0 +1,273 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "capacityrollups.h"
+
+#include "hostinfo.h"
+#include "job.h"
+
+#include <QDateTime>
+
+#include <iterator>
+
+CapacityRollups::CapacityRollups(HostInfoManager *manager, QObject *parent)
+    : QObject(parent)
+    , m_hostInfoManager(manager)
+{
+}
+
+int CapacityRollups::bucketMsecs(Resolution resolution)
+{
+    switch (resolution) {
+    case Seconds:
+        return 1000;
+    case TenSeconds:
+        return 10 * 1000;
+    default:
+        return 60 * 1000;
+    }
+}
+
+int CapacityRollups::bucketCount(Resolution resolution)
+{
+    // 15 minutes, 2 hours and a day
+    switch (resolution) {
+    case Seconds:
+        return 15 * 60;
+    case TenSeconds:
+        return 2 * 60 * 6;
+    default:
+        return 24 * 60;
+    }
+}
+
+CapacityRollups::Resolution CapacityRollups::resolutionFor(qint64 msecs)
+{
+    for (int r = Seconds; r < Minutes; ++r) {
+        const auto resolution = static_cast<Resolution>(r);
+        if (qint64(bucketMsecs(resolution)) * bucketCount(resolution) >= msecs) {
+            return resolution;
+        }
+    }
+    return Minutes;
+}
+
+QVector<CapacityRollups::Sample> CapacityRollups::samples(const QString &platform, Resolution resolution, qint64 from) const
+{
+    const auto it = m_platforms.constFind(platform);
+    if (it == m_platforms.constEnd()) {
+        return {};
+    }
+
+    const PlatformLoad &load = *it;
+    const Series &series = load.series[resolution];
+    const qint64 msecs = bucketMsecs(resolution);
+    const int count = series.buckets.size();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 current = now / msecs;
+    const qint64 first = qMax(from / msecs, current - count + 1);
+
+    QVector<Sample> samples;
+    samples.reserve(int(current - first + 1));
+    for (qint64 b = first; b <= current; ++b) {
+        Bucket bucket;
+        if (b <= series.bucket && b > series.bucket - count) {
+            bucket = series.buckets.at(b % count);
+        }
+
+        // What happened since the last change isn't integrated yet
+        const qint64 start = b * msecs;
+        const qint64 end = qMin(now, start + msecs);
+        const qint64 pending = end - qMax(start, load.lastChange);
+        if (pending > 0) {
+            bucket.active += quint64(qMax(0, load.active)) * pending;
+            bucket.capacity += quint64(qMax(0, load.capacity)) * pending;
+        }
+
+        const double length = qMax<qint64>(1, end - start);
+        samples.append(Sample{start, bucket.active / length, bucket.capacity / length});
+    }
+    return samples;
+}
+
+void CapacityRollups::updateJob(const Job &job)
+{
+    const auto it = m_activeJobs.find(job.id);
+    if (job.isActive()) {
+        const HostId hostid = job.server ? job.server : job.client;
+        if (it != m_activeJobs.end()) {
+            if (*it == hostid) {
+                return;
+            }
+            changeActiveJobs(*it, -1);
+            *it = hostid;
+        } else {
+            m_activeJobs.insert(job.id, hostid);
+        }
+        changeActiveJobs(hostid, 1);
+    } else if (it != m_activeJobs.end()) {
+        changeActiveJobs(*it, -1);
+        m_activeJobs.erase(it);
+    }
+}
+
+void CapacityRollups::updateHost(HostId hostid)
+{
+    const HostInfo *info = m_hostInfoManager ? m_hostInfoManager->find(hostid) : nullptr;
+    if (!info || info->isOffline()) {
+        removeHost(hostid);
+        return;
+    }
+
+    const bool counted = !info->noRemote() && !info->platform().isEmpty();
+    const int capacity = counted ? int(info->maxJobs()) : 0;
+
+    HostState &host = m_hosts[hostid];
+    if (host.platform == info->platform() && host.counted == counted && host.capacity == capacity) {
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (host.counted) {
+        PlatformLoad &load = platformLoad(host.platform, now);
+        integrate(load, now);
+        load.capacity -= host.capacity;
+        load.active -= host.active;
+    }
+
+    host.platform = info->platform();
+    host.counted = counted;
+    host.capacity = capacity;
+
+    if (host.counted) {
+        PlatformLoad &load = platformLoad(host.platform, now);
+        integrate(load, now);
+        load.capacity += host.capacity;
+        load.active += host.active;
+    }
+}
+
+void CapacityRollups::removeHost(HostId hostid)
+{
+    const auto it = m_hosts.find(hostid);
+    if (it == m_hosts.end()) {
+        return;
+    }
+
+    if (it->counted) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        PlatformLoad &load = platformLoad(it->platform, now);
+        integrate(load, now);
+        load.capacity -= it->capacity;
+        load.active -= it->active;
+    }
+    m_hosts.erase(it);
+
+    // Hosts go away rarely, forget their jobs so they can't count again later
+    for (auto job = m_activeJobs.begin(); job != m_activeJobs.end();) {
+        job = (*job == hostid) ? m_activeJobs.erase(job) : std::next(job);
+    }
+}
+
+void CapacityRollups::clear()
+{
+    // Nothing runs anywhere from now on, until the hosts come back
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (PlatformLoad &load : m_platforms) {
+        integrate(load, now);
+        load.active = 0;
+        load.capacity = 0;
+    }
+
+    m_hosts.clear();
+    m_activeJobs.clear();
+}
+
+void CapacityRollups::changeActiveJobs(HostId hostid, int delta)
+{
+    auto it = m_hosts.find(hostid);
+    if (it == m_hosts.end()) {
+        updateHost(hostid);
+        it = m_hosts.find(hostid);
+        if (it == m_hosts.end()) {
+            return;
+        }
+    }
+
+    it->active += delta;
+    if (it->counted) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        PlatformLoad &load = platformLoad(it->platform, now);
+        integrate(load, now);
+        load.active += delta;
+    }
+}
+
+CapacityRollups::PlatformLoad &CapacityRollups::platformLoad(const QString &platform, qint64 now)
+{
+    auto it = m_platforms.find(platform);
+    if (it != m_platforms.end()) {
+        return *it;
+    }
+
+    PlatformLoad load;
+    load.lastChange = now;
+    for (int r = 0; r < _ResolutionCount; ++r) {
+        const auto resolution = static_cast<Resolution>(r);
+        load.series[r].buckets.resize(bucketCount(resolution));
+        load.series[r].bucket = now / bucketMsecs(resolution);
+    }
+    it = m_platforms.insert(platform, load);
+    emit platformsChanged();
+    return *it;
+}
+
+void CapacityRollups::integrate(PlatformLoad &load, qint64 now)
+{
+    for (int r = 0; r < _ResolutionCount; ++r) {
+        Series &series = load.series[r];
+        const qint64 msecs = bucketMsecs(static_cast<Resolution>(r));
+        const int count = series.buckets.size();
+        const qint64 bucket = now / msecs;
+
+        // Buckets coming round again start empty
+        if (bucket > series.bucket) {
+            for (qint64 b = qMax(series.bucket + 1, bucket - count + 1); b <= bucket; ++b) {
+                series.buckets[b % count] = Bucket();
+            }
+            series.bucket = bucket;
+        }
+
+        if (load.active == 0 && load.capacity == 0) {
+            continue;
+        }
+
+        // Split the time since the last change at the bucket boundaries
+        qint64 from = qMax(load.lastChange, (bucket - count + 1) * msecs);
+        while (from < now) {
+            const qint64 b = from / msecs;
+            const qint64 to = qMin(now, (b + 1) * msecs);
+            Bucket &target = series.buckets[b % count];
+            target.active += quint64(qMax(0, load.active)) * (to - from);
+            target.capacity += quint64(qMax(0, load.capacity)) * (to - from);
+            from = to;
+        }
+    }
+
+    load.lastChange = now;
+}
@@ -0,0 +1,127 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_CAPACITYROLLUPS_H
+#define ICEMON_CAPACITYROLLUPS_H
+
+#include "types.h"
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+class HostInfoManager;
+class Job;
+
+/**
+ * Active jobs and job slots per platform over time
+ *
+ * Counts the same way as the job statistics in the status bar: only hosts
+ * which are online and accept remote jobs. Both numbers are integrated
+ * over time into buckets of one second, ten seconds and one minute
+ * whenever they change, so a change costs a constant amount of work and
+ * reading a series doesn't need to look at any job.
+ */
+class CapacityRollups
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Resolution
+    {
+        Seconds,
+        TenSeconds,
+        Minutes,
+        _ResolutionCount
+    };
+
+    /// Averages over a bucket starting at time, in msecs since the epoch
+    struct Sample
+    {
+        qint64 time;
+        double active;
+        double capacity;
+    };
+
+    explicit CapacityRollups(HostInfoManager *manager, QObject *parent = nullptr);
+
+    static int bucketMsecs(Resolution resolution);
+    static int bucketCount(Resolution resolution);
+    /// The finest resolution which still covers @p msecs
+    static Resolution resolutionFor(qint64 msecs);
+
+    QStringList platforms() const { return m_platforms.keys(); }
+
+    /// Samples of the buckets from @p from up to now, the current one included
+    QVector<Sample> samples(const QString &platform, Resolution resolution, qint64 from) const;
+
+public Q_SLOTS:
+    void updateJob(const Job &job);
+    void updateHost(HostId hostid);
+    void removeHost(HostId hostid);
+    /// Forgets all hosts and jobs, the history up to now is kept
+    void clear();
+
+Q_SIGNALS:
+    void platformsChanged();
+
+private:
+    struct Bucket
+    {
+        /// Integrals in job slot msecs
+        quint64 active{0};
+        quint64 capacity{0};
+    };
+
+    struct Series
+    {
+        qint64 bucket{0};
+        QVector<Bucket> buckets;
+    };
+
+    struct PlatformLoad
+    {
+        int active{0};
+        int capacity{0};
+        qint64 lastChange{0};
+        Series series[_ResolutionCount];
+    };
+
+    struct HostState
+    {
+        QString platform;
+        int capacity{0};
+        bool counted{false};
+        int active{0};
+    };
+
+    PlatformLoad &platformLoad(const QString &platform, qint64 now);
+    void integrate(PlatformLoad &load, qint64 now);
+    void changeActiveJobs(HostId hostid, int delta);
+
+    HostInfoManager *m_hostInfoManager;
+    QMap<QString, PlatformLoad> m_platforms;
+    QHash<HostId, HostState> m_hosts;
+    /// Host each active job is counted for
+    QHash<unsigned int, HostId> m_activeJobs;
+};
+
+#endif // ICEMON_CAPACITYROLLUPS_H
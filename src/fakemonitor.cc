@@ -22,12 +22,12 @@
 
 #include "statusview.h"
 #include "job.h"
+#include "framescheduler.h"
 #include "hostinfo.h"
 
 #include <QDebug>
 #include <QStringList>
 #include <QTime>
-#include <QTimer>
 #include <QRandomGenerator>
 
 #include <icecc/comm.h>
@@ -61,11 +61,10 @@ QString randomPlatform()
 
 FakeMonitor::FakeMonitor(HostInfoManager *manager, QObject *parent)
     : Monitor(manager, parent)
-    , m_updateTimer(new QTimer(this))
 {
-    m_updateTimer->setInterval(200);
-    m_updateTimer->start();
-    connect(m_updateTimer, &QTimer::timeout, this, &FakeMonitor::update);
+    // Stands in for the scheduler connection, which keeps running while the views are suspended
+    FrameScheduler::instance()->addCallback(this, [this]() { update(); }, 200, true,
+                                            FrameScheduler::RunWhileSuspendedOption);
 
     setSchedulerState(Online);
 
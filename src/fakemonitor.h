@@ -28,8 +28,6 @@
 class HostInfoManager;
 class StatusView;
 
-class QTimer;
-
 class FakeMonitor
     : public Monitor
 {
@@ -45,8 +43,6 @@ private:
     void createHostInfo(HostId id);
 
     QList<Job> m_activeJobs;
-
-    QTimer *m_updateTimer;
 };
 
 #endif // ICEMON_FAKEMONITOR_H
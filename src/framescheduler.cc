@@ -0,0 +1,242 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "framescheduler.h"
+
+#include <QCoreApplication>
+#include <QWidget>
+
+#include <utility>
+
+namespace {
+
+const int MinFrameRate = 1;
+const int MaxFrameRate = 60;
+
+}
+
+FrameScheduler *FrameScheduler::instance()
+{
+    // Owned by the application, so it goes away before the event loop does
+    static QPointer<FrameScheduler> s_instance;
+    if (!s_instance) {
+        s_instance = new FrameScheduler(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+FrameScheduler::FrameScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &FrameScheduler::frame);
+}
+
+void FrameScheduler::setFrameRate(int framesPerSecond)
+{
+    framesPerSecond = qBound(MinFrameRate, framesPerSecond, MaxFrameRate);
+    if (m_frameRate == framesPerSecond) {
+        return;
+    }
+
+    m_frameRate = framesPerSecond;
+    if (!m_inFrame) {
+        scheduleNextFrame();
+    }
+}
+
+void FrameScheduler::setSuspended(bool suspended)
+{
+    if (m_suspended == suspended) {
+        return;
+    }
+
+    m_suspended = suspended;
+    if (!m_inFrame) {
+        scheduleNextFrame();
+    }
+}
+
+int FrameScheduler::addCallback(QObject *owner, const Callback &callback, int intervalMsecs, bool enabled,
+                                CallbackOptions options)
+{
+    const int id = m_nextId++;
+
+    Entry entry;
+    entry.callback = callback;
+    entry.interval = qMax(0, intervalMsecs);
+    entry.due = m_clock.elapsed() + entry.interval;
+    entry.enabled = enabled;
+    entry.options = options;
+    m_callbacks.insert(id, entry);
+
+    connect(owner, &QObject::destroyed, this, [this, id]() {
+        removeCallback(id);
+    });
+
+    if (isRunnable(entry)) {
+        requestFrame(entry.due);
+    }
+    return id;
+}
+
+void FrameScheduler::removeCallback(int id)
+{
+    m_callbacks.remove(id);
+}
+
+void FrameScheduler::setCallbackEnabled(int id, bool enabled)
+{
+    const auto it = m_callbacks.find(id);
+    if (it == m_callbacks.end() || it->enabled == enabled) {
+        return;
+    }
+
+    it->enabled = enabled;
+    if (enabled) {
+        it->due = m_clock.elapsed() + it->interval;
+        if (isRunnable(*it)) {
+            requestFrame(it->due);
+        }
+    }
+}
+
+void FrameScheduler::setCallbackInterval(int id, int intervalMsecs)
+{
+    const auto it = m_callbacks.find(id);
+    if (it == m_callbacks.end()) {
+        return;
+    }
+
+    intervalMsecs = qMax(0, intervalMsecs);
+    it->due += intervalMsecs - it->interval;
+    it->interval = intervalMsecs;
+    if (isRunnable(*it)) {
+        requestFrame(it->due);
+    }
+}
+
+void FrameScheduler::markDirty(QWidget *widget, const QRect &rect)
+{
+    if (!widget || !widget->isVisible()) {
+        return;
+    }
+
+    DirtyWidget &dirty = m_dirty[widget];
+    if (!dirty.widget) {
+        // A new entry, or one left behind by a deleted widget at the same address
+        dirty.widget = widget;
+        dirty.region = QRegion();
+        dirty.all = false;
+    }
+    if (rect.isNull()) {
+        dirty.all = true;
+    } else if (!dirty.all) {
+        dirty.region += rect;
+    }
+
+    requestFrame(m_clock.elapsed());
+}
+
+void FrameScheduler::frame()
+{
+    // Timers may fire a little early or late, the frame is the closest tick
+    const int interval = frameInterval();
+    m_lastFrame = (m_clock.elapsed() + interval / 2) / interval * interval;
+    m_nextFrame = -1;
+    m_inFrame = true;
+
+    // Callbacks may add or remove callbacks, so go by id
+    const QList<int> ids = m_callbacks.keys();
+    for (int id : ids) {
+        auto it = m_callbacks.find(id);
+        if (it == m_callbacks.end() || !isRunnable(*it) || it->due > m_lastFrame) {
+            continue;
+        }
+
+        // Measured from the frame, so intervals don't drift by the timer latency
+        it->due = m_lastFrame + it->interval;
+        const Callback callback = it->callback;
+        callback();
+    }
+
+    // The repaints of the whole frame, after all callbacks marked theirs
+    const QHash<QWidget *, DirtyWidget> dirty = std::exchange(m_dirty, {});
+    for (const DirtyWidget &entry : dirty) {
+        if (!entry.widget) {
+            continue;
+        }
+        if (entry.all) {
+            entry.widget->update();
+        } else {
+            entry.widget->update(entry.region);
+        }
+    }
+
+    m_inFrame = false;
+    scheduleNextFrame();
+}
+
+bool FrameScheduler::isRunnable(const Entry &entry) const
+{
+    return entry.enabled && (!m_suspended || entry.options & RunWhileSuspendedOption);
+}
+
+void FrameScheduler::requestFrame(qint64 time)
+{
+    // The frame will look at everything once it's done with the callbacks
+    if (m_inFrame) {
+        return;
+    }
+
+    const int interval = frameInterval();
+    qint64 frameTime = (time + interval - 1) / interval * interval;
+    if (m_lastFrame >= 0) {
+        frameTime = qMax(frameTime, m_lastFrame + interval);
+    }
+
+    if (m_timer.isActive() && m_nextFrame <= frameTime) {
+        return;
+    }
+
+    m_nextFrame = frameTime;
+    m_timer.start(int(qMax<qint64>(0, frameTime - m_clock.elapsed())));
+}
+
+void FrameScheduler::scheduleNextFrame()
+{
+    m_timer.stop();
+    m_nextFrame = -1;
+
+    qint64 next = -1;
+    if (!m_dirty.isEmpty()) {
+        next = m_clock.elapsed();
+    }
+    for (const Entry &entry : std::as_const(m_callbacks)) {
+        if (isRunnable(entry) && (next < 0 || entry.due < next)) {
+            next = entry.due;
+        }
+    }
+
+    // Nothing to do, no wakeups until something changes
+    if (next >= 0) {
+        requestFrame(next);
+    }
+}
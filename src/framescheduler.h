@@ -0,0 +1,124 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_FRAMESCHEDULER_H
+#define ICEMON_FRAMESCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QRegion>
+#include <QTimer>
+
+#include <functional>
+
+class QWidget;
+
+/**
+ * The one clock all periodic refreshes run on
+ *
+ * Instead of running timers of their own, views register callbacks which
+ * are called on the frame ticks, and mark the parts of their widgets which
+ * need repainting. Everything due within a frame is done in one pass, the
+ * repaints last. When no callback is due and nothing is dirty, the frame is
+ * skipped and the timer is only started again for the next due callback.
+ *
+ * While suspended, e.g. when nobody can see the window, the callbacks
+ * aren't called at all and there are no wakeups for them.
+ */
+class FrameScheduler
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void()>;
+
+    enum CallbackOption {
+        NoCallbackOptions = 0, ///< No option
+        RunWhileSuspendedOption = 1 ///< Keep calling back while suspended, for things other than rendering
+    };
+    Q_DECLARE_FLAGS(CallbackOptions, CallbackOption)
+
+    static FrameScheduler *instance();
+
+    int frameRate() const { return m_frameRate; }
+    void setFrameRate(int framesPerSecond);
+    int frameInterval() const { return 1000 / m_frameRate; }
+
+    bool isSuspended() const { return m_suspended; }
+    void setSuspended(bool suspended);
+
+    /**
+     * Calls @p callback on the frames at least @p intervalMsecs apart, on
+     * every frame for an interval of 0. The callback goes away with @p owner.
+     *
+     * @return Handle for the other callback functions
+     */
+    int addCallback(QObject *owner, const Callback &callback, int intervalMsecs = 0, bool enabled = true,
+                    CallbackOptions options = NoCallbackOptions);
+    void removeCallback(int id);
+    void setCallbackEnabled(int id, bool enabled);
+    void setCallbackInterval(int id, int intervalMsecs);
+
+    /// Repaints @p rect of @p widget with the next frame, all of it for a null rect.
+    /// Hidden widgets are skipped, Qt repaints them completely when they are shown.
+    void markDirty(QWidget *widget, const QRect &rect = QRect());
+
+private Q_SLOTS:
+    void frame();
+
+private:
+    explicit FrameScheduler(QObject *parent = nullptr);
+
+    struct Entry
+    {
+        Callback callback;
+        int interval{0};
+        qint64 due{0};
+        bool enabled{true};
+        CallbackOptions options;
+    };
+
+    struct DirtyWidget
+    {
+        QPointer<QWidget> widget;
+        QRegion region;
+        bool all{false};
+    };
+
+    bool isRunnable(const Entry &entry) const;
+    void requestFrame(qint64 time);
+    void scheduleNextFrame();
+
+    int m_frameRate{30};
+    int m_nextId{1};
+    bool m_inFrame{false};
+    bool m_suspended{false};
+    qint64 m_lastFrame{-1};
+    qint64 m_nextFrame{-1};
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    QHash<int, Entry> m_callbacks;
+    QHash<QWidget *, DirtyWidget> m_dirty;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FrameScheduler::CallbackOptions)
+
+#endif // ICEMON_FRAMESCHEDULER_H
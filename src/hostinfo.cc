@@ -29,6 +29,11 @@ QMap<int, QString> HostInfo::mColorNameMap;
 
 void HostInfo::initColorTable()
 {
+    // Shared by all hosts, only built when the first one needs a colour
+    if (!mColorTable.isEmpty()) {
+        return;
+    }
+
     initColor(QStringLiteral("#A5080B"), QApplication::tr("cherry"));
     initColor(QStringLiteral("#76d26f"), QApplication::tr("pistachio"));
     initColor(QStringLiteral("#664a08"), QApplication::tr("chocolate"));
@@ -75,6 +80,8 @@ void HostInfo::initColor(const QString &value, const QString &name)
 
 QString HostInfo::colorName(const QColor &c)
 {
+    initColorTable();
+
     int key = c.red() + c.green() * 256 + c.blue() * 65536;
 
     return mColorNameMap.value(key, QApplication::tr("<unknown>"));
@@ -127,6 +134,8 @@ void HostInfo::updateFromStatsMap(const StatsMap &stats)
 
 QColor HostInfo::createColor(const QString &name)
 {
+    initColorTable();
+
     unsigned long h = 0;
 
     for (uint i = 0; i < ( uint )name.length(); ++i) {
@@ -151,12 +160,13 @@ QColor HostInfo::createColor()
 {
     static int num = 0;
 
+    initColorTable();
+
     return mColorTable.at(num++ % mColorTable.count());
 }
 
 HostInfoManager::HostInfoManager()
 {
-    HostInfo::initColorTable();
 }
 
 HostInfoManager::~HostInfoManager()
@@ -0,0 +1,159 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "hostutilization.h"
+
+#include "hostinfo.h"
+#include "job.h"
+
+#include <QDateTime>
+
+#include <iterator>
+
+HostUtilization::HostUtilization(HostInfoManager *manager, QObject *parent)
+    : QObject(parent)
+    , m_hostInfoManager(manager)
+{
+}
+
+bool HostUtilization::levels(HostId hostid, qint64 now, float *levels) const
+{
+    const auto it = m_hosts.constFind(hostid);
+    if (it == m_hosts.constEnd()) {
+        return false;
+    }
+
+    // What happened since the last change isn't integrated yet
+    HostLoad load = *it;
+    accumulate(load, now);
+
+    const qint64 current = now / BucketMsecs;
+    const qint64 firstBucket = current - BucketCount + 1;
+    const float slots = float(qMax(1, load.maxJobs));
+    for (int column = 0; column < BucketCount - 1; ++column) {
+        const qint64 bucket = firstBucket + column;
+        levels[column] = bucket < 0 ? 0.0f : load.busy[bucket % BucketCount] / (slots * BucketMsecs);
+    }
+
+    const qint64 currentLength = qMax<qint64>(1, now - current * BucketMsecs);
+    levels[BucketCount - 1] = load.busy[current % BucketCount] / (slots * currentLength);
+    return true;
+}
+
+void HostUtilization::updateJob(const Job &job)
+{
+    const auto it = m_activeJobs.find(job.id);
+    if (job.isActive()) {
+        const HostId hostid = (job.state == Job::LocalOnly || !job.server) ? job.client : job.server;
+        if (it != m_activeJobs.end()) {
+            if (*it == hostid) {
+                return;
+            }
+            changeActiveJobs(*it, -1);
+            *it = hostid;
+        } else {
+            m_activeJobs.insert(job.id, hostid);
+        }
+        changeActiveJobs(hostid, 1);
+    } else if (it != m_activeJobs.end()) {
+        changeActiveJobs(*it, -1);
+        m_activeJobs.erase(it);
+    }
+}
+
+void HostUtilization::updateHost(HostId hostid)
+{
+    const HostInfo *info = m_hostInfoManager ? m_hostInfoManager->find(hostid) : nullptr;
+    if (!info || info->isOffline()) {
+        removeHost(hostid);
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto it = m_hosts.find(hostid);
+    if (it == m_hosts.end()) {
+        HostLoad load;
+        load.lastChange = now;
+        load.bucket = now / BucketMsecs;
+        it = m_hosts.insert(hostid, load);
+    } else {
+        // The busy time so far counts against the old number of slots
+        accumulate(*it, now);
+    }
+    it->maxJobs = int(info->maxJobs());
+}
+
+void HostUtilization::removeHost(HostId hostid)
+{
+    if (!m_hosts.remove(hostid)) {
+        return;
+    }
+
+    // Hosts go away rarely, forget their jobs so they can't count again later
+    for (auto job = m_activeJobs.begin(); job != m_activeJobs.end();) {
+        job = (*job == hostid) ? m_activeJobs.erase(job) : std::next(job);
+    }
+}
+
+void HostUtilization::clear()
+{
+    m_hosts.clear();
+    m_activeJobs.clear();
+}
+
+void HostUtilization::changeActiveJobs(HostId hostid, int delta)
+{
+    auto it = m_hosts.find(hostid);
+    if (it == m_hosts.end()) {
+        updateHost(hostid);
+        it = m_hosts.find(hostid);
+        if (it == m_hosts.end()) {
+            return;
+        }
+    }
+
+    accumulate(*it, QDateTime::currentMSecsSinceEpoch());
+    it->active = qMax(0, it->active + delta);
+}
+
+void HostUtilization::accumulate(HostLoad &load, qint64 now)
+{
+    const qint64 bucket = now / BucketMsecs;
+    if (bucket > load.bucket) {
+        // Buckets which come round again start empty
+        const qint64 first = qMax(load.bucket + 1, bucket - BucketCount + 1);
+        for (qint64 b = first; b <= bucket; ++b) {
+            load.busy[b % BucketCount] = 0;
+        }
+    }
+
+    // Split the interval since the last change at the bucket boundaries,
+    // only more than one bucket if the host kept busy for over a minute
+    if (load.active > 0) {
+        qint64 from = qMax(load.lastChange, (bucket - BucketCount + 1) * BucketMsecs);
+        while (from < now) {
+            const qint64 b = from / BucketMsecs;
+            const qint64 to = qMin(now, (b + 1) * BucketMsecs);
+            load.busy[b % BucketCount] += quint32(load.active * (to - from));
+            from = to;
+        }
+    }
+
+    load.bucket = qMax(load.bucket, bucket);
+    load.lastChange = qMax(load.lastChange, now);
+}
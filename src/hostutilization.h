@@ -0,0 +1,88 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_HOSTUTILIZATION_H
+#define ICEMON_HOSTUTILIZATION_H
+
+#include "types.h"
+
+#include <QHash>
+#include <QObject>
+
+class HostInfoManager;
+class Job;
+
+/**
+ * Busy job slots of every host over the last hour
+ *
+ * The busy time of a host is integrated into one minute buckets whenever
+ * its number of active jobs changes, so reading it doesn't need to look at
+ * any job. It is owned by the monitor and keeps counting while the views
+ * showing it are paused or hidden.
+ */
+class HostUtilization
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        BucketCount = 60,
+        BucketMsecs = 60 * 1000
+    };
+
+    explicit HostUtilization(HostInfoManager *manager, QObject *parent = nullptr);
+
+    /**
+     * Fills @p levels with the share of the job slots of @p hostid which
+     * were busy in each of the last BucketCount buckets up to @p now, in
+     * msecs since the epoch. The oldest bucket comes first, the current one
+     * last and is measured up to @p now.
+     *
+     * @return false if the host isn't known, @p levels is left alone then
+     */
+    bool levels(HostId hostid, qint64 now, float *levels) const;
+
+public Q_SLOTS:
+    void updateJob(const Job &job);
+    void updateHost(HostId hostid);
+    void removeHost(HostId hostid);
+    /// Forgets all hosts and jobs
+    void clear();
+
+private:
+    /// Each bucket holds the milliseconds of busy job slots
+    struct HostLoad
+    {
+        int maxJobs{0};
+        int active{0};
+        qint64 lastChange{0};
+        qint64 bucket{0};
+        quint32 busy[BucketCount]{};
+    };
+
+    static void accumulate(HostLoad &load, qint64 now);
+    void changeActiveJobs(HostId hostid, int delta);
+
+    HostInfoManager *m_hostInfoManager;
+    QHash<HostId, HostLoad> m_hosts;
+    /// Host each active job is counted for
+    QHash<unsigned int, HostId> m_activeJobs;
+};
+
+#endif // ICEMON_HOSTUTILIZATION_H
@@ -23,7 +23,11 @@
 
 #include "icecreammonitor.h"
 
+#include "capacityrollups.h"
 #include "hostinfo.h"
+#include "hostutilization.h"
+#include "sessiondetector.h"
+#include "startuptrace.h"
 #include "statusview.h"
 
 #include <config-icemon.h>
@@ -55,7 +59,12 @@ IcecreamMonitor::IcecreamMonitor(HostInfoManager *manager, QObject *parent)
     : Monitor(manager, parent)
 {
     setupDebug();
-    checkScheduler();
+
+    // The first attempt right away, checkScheduler() spreads out the retries
+    QTimer::singleShot(0, this, [this]() {
+        StartupTrace::mark(QStringLiteral("scheduler discovery started"));
+        slotCheckScheduler();
+    });
 }
 
 IcecreamMonitor::~IcecreamMonitor()
@@ -64,15 +73,14 @@ IcecreamMonitor::~IcecreamMonitor()
     delete m_discover;
 }
 
-QList<Job> IcecreamMonitor::jobHistory() const
-{
-    return m_rememberedJobs.values();
-}
-
 void IcecreamMonitor::checkScheduler(bool deleteit)
 {
     if (deleteit) {
         m_rememberedJobs.clear();
+        jobStore()->clear();
+        sessionDetector()->clear();
+        capacityRollups()->clear();
+        hostUtilization()->clear();
         delete m_scheduler;
         m_scheduler = nullptr;
         delete m_fd_notify;
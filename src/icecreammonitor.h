@@ -43,8 +43,6 @@ public:
     IcecreamMonitor(HostInfoManager *, QObject *parent);
     ~IcecreamMonitor() override;
 
-    QList<Job> jobHistory() const override;
-
 private slots:
     void slotCheckScheduler();
     void msgReceived();
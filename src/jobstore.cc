@@ -0,0 +1,224 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "jobstore.h"
+
+#include <QDateTime>
+
+namespace {
+
+/// Running jobs without any update for this long are taken as lost
+const qint64 MaxJobSilence = 60 * 60 * 1000;
+
+}
+
+JobStore::JobStore(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void JobStore::setMaxJobs(int count)
+{
+    m_maxJobs = qMax(1, count);
+    dropOldestJobs();
+}
+
+const Job *JobStore::find(unsigned int jobId) const
+{
+    const auto it = m_jobs.constFind(jobId);
+    return it == m_jobs.constEnd() ? nullptr : &it->job;
+}
+
+QVector<unsigned int> JobStore::jobsForHost(Index index, HostId host) const
+{
+    return m_indexes[index].value(host);
+}
+
+QVector<Job> JobStore::snapshot() const
+{
+    QVector<Job> jobs;
+    jobs.reserve(m_order.size());
+    for (unsigned int jobId : m_order) {
+        jobs.append(m_jobs.value(jobId).job);
+    }
+    return jobs;
+}
+
+JobStore::Delta JobStore::changesSince(quint64 sequence) const
+{
+    Delta delta;
+    for (auto it = m_changes.upperBound(sequence); it != m_changes.constEnd(); ++it) {
+        delta.jobs.append(m_jobs.value(*it).job);
+    }
+    // There are few hosts compared to jobs, no need for another index
+    for (auto it = m_hosts.constBegin(); it != m_hosts.constEnd(); ++it) {
+        if (it->sequence > sequence) {
+            (it->removed ? delta.removedHosts : delta.updatedHosts).append(it.key());
+        }
+    }
+    return delta;
+}
+
+void JobStore::addListener(Index index, HostId host, Listener *listener)
+{
+    m_listeners[index].insert(host, listener);
+}
+
+void JobStore::removeListener(Index index, HostId host, Listener *listener)
+{
+    m_listeners[index].remove(host, listener);
+}
+
+void JobStore::update(const Job &job)
+{
+    auto it = m_jobs.find(job.id);
+    if (it == m_jobs.end()) {
+        it = m_jobs.insert(job.id, Entry{job});
+        touch(*it);
+        m_order.append(job.id);
+        addToIndex(ByClient, job.client, it->job);
+        addToIndex(ByServer, job.server, it->job);
+
+        if (m_jobs.size() > m_maxJobs) {
+            dropOldestJobs();
+        }
+        return;
+    }
+
+    const HostId oldClient = it->job.client;
+    const HostId oldServer = it->job.server;
+    it->job = job;
+    touch(*it);
+
+    // The server is only known once the scheduler assigned one
+    if (oldClient != job.client) {
+        removeFromIndex(ByClient, oldClient, job.id);
+        addToIndex(ByClient, job.client, it->job);
+    } else {
+        notifyStored(ByClient, job.client, it->job);
+    }
+    if (oldServer != job.server) {
+        removeFromIndex(ByServer, oldServer, job.id);
+        addToIndex(ByServer, job.server, it->job);
+    } else {
+        notifyStored(ByServer, job.server, it->job);
+    }
+}
+
+void JobStore::touch(Entry &entry)
+{
+    if (entry.sequence) {
+        m_changes.remove(entry.sequence);
+    }
+    entry.sequence = ++m_sequence;
+    entry.lastUpdate = QDateTime::currentMSecsSinceEpoch();
+    m_changes.insert(entry.sequence, entry.job.id);
+}
+
+void JobStore::hostUpdated(HostId host)
+{
+    m_hosts.insert(host, HostState{++m_sequence, false});
+}
+
+void JobStore::hostRemoved(HostId host)
+{
+    m_hosts.insert(host, HostState{++m_sequence, true});
+}
+
+void JobStore::clear()
+{
+    m_jobs.clear();
+    m_order.clear();
+    m_changes.clear();
+    m_hosts.clear();
+    for (HostIndex &index : m_indexes) {
+        index.clear();
+    }
+    emit cleared();
+}
+
+void JobStore::addToIndex(Index index, HostId host, const Job &job)
+{
+    if (!host) {
+        return;
+    }
+
+    m_indexes[index][host].append(job.id);
+    notifyStored(index, host, job);
+}
+
+void JobStore::removeFromIndex(Index index, HostId host, unsigned int jobId)
+{
+    if (!host) {
+        return;
+    }
+
+    auto it = m_indexes[index].find(host);
+    if (it == m_indexes[index].end()) {
+        return;
+    }
+    // The oldest jobs are dropped first, so this rarely has to look far
+    it->removeOne(jobId);
+    if (it->isEmpty()) {
+        m_indexes[index].erase(it);
+    }
+
+    const Listeners &listeners = m_listeners[index];
+    for (auto listener = listeners.constFind(host); listener != listeners.constEnd() && listener.key() == host; ++listener) {
+        (*listener)->jobDropped(jobId);
+    }
+}
+
+void JobStore::notifyStored(Index index, HostId host, const Job &job) const
+{
+    if (!host) {
+        return;
+    }
+
+    const Listeners &listeners = m_listeners[index];
+    for (auto listener = listeners.constFind(host); listener != listeners.constEnd() && listener.key() == host; ++listener) {
+        (*listener)->jobStored(job);
+    }
+}
+
+void JobStore::dropOldestJobs()
+{
+    // Jobs which are still running keep their place and are checked again
+    // later, the ones in front of them move up so the order stays oldest first.
+    // Without the end of a job it would run forever, so silent ones go too.
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int kept = 0;
+    int next = 0;
+    for (; next < m_order.size() && m_jobs.size() > m_maxJobs; ++next) {
+        const unsigned int jobId = m_order.at(next);
+        const auto it = m_jobs.constFind(jobId);
+        if (it == m_jobs.constEnd()) {
+            continue;
+        }
+        if (!it->job.isDone() && now - it->lastUpdate <= MaxJobSilence) {
+            m_order[kept++] = jobId;
+            continue;
+        }
+
+        removeFromIndex(ByClient, it->job.client, jobId);
+        removeFromIndex(ByServer, it->job.server, jobId);
+        m_changes.remove(it->sequence);
+        m_jobs.erase(it);
+    }
+    m_order.erase(m_order.begin() + kept, m_order.begin() + next);
+}
@@ -0,0 +1,145 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_JOBSTORE_H
+#define ICEMON_JOBSTORE_H
+
+#include "job.h"
+#include "types.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QVector>
+
+/**
+ * The retained jobs of a monitor
+ *
+ * Every job is stored once, with secondary indexes of the job ids by
+ * client and by server host in the order the jobs were seen. Listeners
+ * subscribe to one host of one index and are only told about the jobs
+ * of that host.
+ *
+ * Every change of a job or host bumps a sequence number, so a consumer
+ * which stopped listening can catch up with changesSince().
+ */
+class JobStore
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Index
+    {
+        ByClient,
+        ByServer
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /// @p job was added to the host or changed
+        virtual void jobStored(const Job &job) = 0;
+        /// The job is no longer in the store or no longer belongs to the host
+        virtual void jobDropped(unsigned int jobId) = 0;
+    };
+
+    /// Final state of everything which changed since a sequence number
+    struct Delta
+    {
+        QVector<Job> jobs;
+        QVector<HostId> updatedHosts;
+        QVector<HostId> removedHosts;
+    };
+
+    explicit JobStore(QObject *parent = nullptr);
+
+    int maxJobs() const { return m_maxJobs; }
+    /**
+     * Finished jobs beyond @p count are dropped, the oldest first. So are
+     * running jobs without any update for an hour, their end was lost.
+     */
+    void setMaxJobs(int count);
+
+    int count() const { return m_jobs.size(); }
+    /// The job with @p jobId, valid until the next change of the store
+    const Job *find(unsigned int jobId) const;
+    /// Ids of the jobs of @p host, the oldest first
+    QVector<unsigned int> jobsForHost(Index index, HostId host) const;
+    /// Current state of all jobs in one block, the oldest first
+    QVector<Job> snapshot() const;
+
+    quint64 sequence() const { return m_sequence; }
+    /// Jobs and hosts changed after @p sequence, each only once, the jobs in the order of their last change
+    Delta changesSince(quint64 sequence) const;
+
+    void addListener(Index index, HostId host, Listener *listener);
+    void removeListener(Index index, HostId host, Listener *listener);
+
+public Q_SLOTS:
+    void update(const Job &job);
+    void hostUpdated(HostId host);
+    void hostRemoved(HostId host);
+    void clear();
+
+Q_SIGNALS:
+    void cleared();
+
+private:
+    struct Entry
+    {
+        Job job;
+        quint64 sequence{0};
+        /// Time of the last update in msecs since the epoch
+        qint64 lastUpdate{0};
+    };
+
+    struct HostState
+    {
+        quint64 sequence{0};
+        bool removed{false};
+    };
+
+    using HostIndex = QHash<HostId, QVector<unsigned int>>;
+    using Listeners = QMultiHash<HostId, Listener *>;
+
+    void addToIndex(Index index, HostId host, const Job &job);
+    void removeFromIndex(Index index, HostId host, unsigned int jobId);
+    void notifyStored(Index index, HostId host, const Job &job) const;
+    void dropOldestJobs();
+    void touch(Entry &entry);
+
+    QHash<unsigned int, Entry> m_jobs;
+    /// Job ids in the order they were added, for dropping the oldest
+    QList<unsigned int> m_order;
+
+    /// Job ids by the sequence number of their last change
+    QMap<quint64, unsigned int> m_changes;
+    QHash<HostId, HostState> m_hosts;
+    quint64 m_sequence{0};
+
+    HostIndex m_indexes[2];
+    Listeners m_listeners[2];
+
+    int m_maxJobs{20000};
+};
+
+#endif // ICEMON_JOBSTORE_H
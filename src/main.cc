@@ -25,11 +25,15 @@
 #include <QApplication>
 #include <QCommandLineParser>
 
+#include "framescheduler.h"
 #include "mainwindow.h"
+#include "startuptrace.h"
 #include "version.h"
 
 int main(int argc, char **argv)
 {
+    StartupTrace::start();
+
     QApplication app(argc, argv);
     QApplication::setOrganizationDomain(QStringLiteral("kde.org"));
     QApplication::setApplicationName(QLatin1String(Icemon::Version::appShortName));
@@ -54,9 +58,19 @@ int main(int argc, char **argv)
     QCommandLineOption testmodeOption(QStringLiteral("testmode"),
         QCoreApplication::translate("main", "Testing mode."));
     parser.addOption(testmodeOption);
+    QCommandLineOption frameRateOption(QStringLiteral("frame-rate"),
+        QCoreApplication::translate("main", "Refreshes of the views per second"),
+        QCoreApplication::translate("main", "fps", "frames per second"));
+    parser.addOption(frameRateOption);
+    QCommandLineOption startupTraceOption(QStringLiteral("startup-trace"),
+        QCoreApplication::translate("main", "Print how long the steps of startup take."));
+    parser.addOption(startupTraceOption);
 
     parser.process(app);
 
+    StartupTrace::setEnabled(parser.isSet(startupTraceOption));
+    StartupTrace::mark(QStringLiteral("application created"));
+
     const QByteArray netName = parser.value(netnameOption).toLatin1();
     const QByteArray schedName = parser.value(schednameOption).toLatin1();
 
@@ -74,6 +88,11 @@ int main(int argc, char **argv)
     if (parser.isSet(testmodeOption)) {
         mainWindow.setTestModeEnabled(true);
     }
+    if (parser.isSet(frameRateOption)) {
+        FrameScheduler::instance()->setFrameRate(parser.value(frameRateOption).toInt());
+    }
+    StartupTrace::mark(QStringLiteral("main window created"));
+    StartupTrace::markFirstPaint(&mainWindow, QStringLiteral("first frame"));
     mainWindow.show();
 
     return app.exec();
@@ -26,7 +26,9 @@
 #include "hostinfo.h"
 #include "version.h"
 #include "fakemonitor.h"
+#include "framescheduler.h"
 #include "icecreammonitor.h"
+#include "startuptrace.h"
 #include "statusview.h"
 #include "statusviewfactory.h"
 
@@ -40,6 +42,8 @@
 #include <QSettings>
 #include <QMenu>
 #include <QActionGroup>
+#include <QStackedWidget>
+#include <QTimer>
 
 #include <algorithm>
 
@@ -51,11 +55,21 @@ struct PlatformStat
     unsigned int maxJobs{0};
 };
 
+// Number of views besides the current one which are kept alive
+const int MaxBackgroundViews = 2;
+
+// Time without active jobs after which the views stop refreshing
+const int IdleGraceMsecs = 10 * 1000;
+
 }
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
+    // Finding the scheduler takes a while, get it going before any widget work
+    m_hostInfoManager = new HostInfoManager;
+    Monitor *monitor = new IcecreamMonitor(m_hostInfoManager, this);
+
     QIcon appIcon = QIcon();
     appIcon.addFile(QStringLiteral(":/images/128-apps-icemon.png"), QSize(128, 128));
     appIcon.addFile(QStringLiteral(":/images/48-apps-icemon.png"), QSize(48, 48));
@@ -123,6 +137,15 @@ MainWindow::MainWindow(QWidget *parent)
     action = m_viewMode->addAction(tr("&Detailed Host View"));
     action->setCheckable(true);
     action->setData(QStringLiteral("detailedhost"));
+    action = m_viewMode->addAction(tr("&Heatmap View"));
+    action->setCheckable(true);
+    action->setData(QStringLiteral("heatmap"));
+    action = m_viewMode->addAction(tr("&Timeline View"));
+    action->setCheckable(true);
+    action->setData(QStringLiteral("timeline"));
+    action = m_viewMode->addAction(tr("S&essions View"));
+    action->setCheckable(true);
+    action->setData(QStringLiteral("sessions"));
     connect(m_viewMode, &QActionGroup::triggered, this, &MainWindow::handleViewModeActionTriggered);
     viewMenu->addActions(m_viewMode->actions());
 
@@ -131,6 +154,7 @@ MainWindow::MainWindow(QWidget *parent)
     action = viewMenu->addAction(tr("Pause"));
     action->setIcon(QIcon::fromTheme(QStringLiteral("media-playback-pause")));
     action->setCheckable(true);
+    action->setEnabled(false);
     connect(action, &QAction::triggered, this, &MainWindow::pauseView);
     m_pauseViewAction = action;
 
@@ -138,6 +162,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     action = viewMenu->addAction(tr("Configure View..."));
     action->setIcon(QIcon::fromTheme(QStringLiteral("configure")));
+    action->setEnabled(false);
     connect(action, &QAction::triggered, this, &MainWindow::configureView);
     m_configureViewAction = action;
 
@@ -150,15 +175,29 @@ MainWindow::MainWindow(QWidget *parent)
     connect(action, &QAction::triggered, this, &MainWindow::about);
     action->setMenuRole(QAction::AboutRole);
 
-    m_hostInfoManager = new HostInfoManager;
-    setMonitor(new IcecreamMonitor(m_hostInfoManager, this));
+    m_viewStack = new QStackedWidget;
+    setCentralWidget(m_viewStack);
+
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(IdleGraceMsecs);
+    connect(m_idleTimer, &QTimer::timeout, this, &MainWindow::clusterBecameIdle);
+
+    setMonitor(monitor);
 
     resize(600, 400);
     readSettings();
+
+    updateClusterActivity();
 }
 
 MainWindow::~MainWindow()
 {
+    // The views own their widgets, delete them before the view stack does
+    clearBackgroundViews();
+    delete m_view;
+    m_view = nullptr;
+
     delete m_hostInfoManager;
 }
 
@@ -188,6 +227,29 @@ void MainWindow::closeEvent(QCloseEvent *e)
     QMainWindow::closeEvent(e);
 }
 
+void MainWindow::showEvent(QShowEvent *e)
+{
+    QMainWindow::showEvent(e);
+
+    updateRendering();
+}
+
+void MainWindow::hideEvent(QHideEvent *e)
+{
+    QMainWindow::hideEvent(e);
+
+    updateRendering();
+}
+
+void MainWindow::changeEvent(QEvent *e)
+{
+    QMainWindow::changeEvent(e);
+
+    if (e->type() == QEvent::WindowStateChange) {
+        updateRendering();
+    }
+}
+
 void MainWindow::readSettings()
 {
     QSettings settings;
@@ -195,9 +257,15 @@ void MainWindow::readSettings()
     restoreState(settings.value(QStringLiteral("windowState")).toByteArray());
     bool showSystemTray = settings.value(QStringLiteral("showSystemTray")).toBool();
     QString viewId = settings.value(QStringLiteral("currentView")).toString();
-
-    auto view = StatusViewFactory::create(viewId, this);
-    setView(view);
+    FrameScheduler *scheduler = FrameScheduler::instance();
+    scheduler->setFrameRate(settings.value(QStringLiteral("frameRate"), scheduler->frameRate()).toInt());
+
+    // Built once the window is up, so the view doesn't delay the first frame
+    QTimer::singleShot(0, this, [this, viewId]() {
+        showView(viewId);
+        StartupTrace::mark(QStringLiteral("%1 view created").arg(m_view->id()));
+        StartupTrace::markFirstPaint(m_view->widget(), QStringLiteral("first view frame"));
+    });
 
     if (m_systemTrayIcon)
     {
@@ -246,6 +314,8 @@ void MainWindow::setMonitor(Monitor *monitor)
         connect(m_monitor->hostInfoManager(), &HostInfoManager::hostMapChanged, this, &MainWindow::updateJobStats);
     }
 
+    // Only the current view moves to the new monitor
+    clearBackgroundViews();
     if (m_view) {
         m_view->setMonitor(m_monitor);
     }
@@ -263,16 +333,46 @@ void MainWindow::setView(StatusView *view)
         return;
     }
 
-    delete m_view;
+    if (m_pausedWhileHidden) {
+        m_pausedWhileHidden = false;
+        m_view->setPaused(false);
+    }
+
+    if (m_view) {
+        // Hidden views don't follow the monitor, they catch up when shown again
+        if (!m_view->isPaused()) {
+            m_view->setPaused(true);
+            m_pausedInBackground.insert(m_view);
+        }
+        m_backgroundViews.prepend(m_view);
+        while (m_backgroundViews.size() > MaxBackgroundViews) {
+            StatusView *oldest = m_backgroundViews.takeLast();
+            m_pausedInBackground.remove(oldest);
+            delete oldest;
+        }
+    }
 
     m_view = view;
 
     if (m_view) {
+        m_backgroundViews.removeOne(m_view);
+        if (m_pausedInBackground.remove(m_view)) {
+            m_view->setPaused(false);
+        }
         m_configureViewAction->setEnabled(m_view->isConfigurable());
         m_pauseViewAction->setEnabled(m_view->isPausable());
-        m_view->setMonitor(m_monitor);
+        m_pauseViewAction->setChecked(m_view->isPaused());
+        // Views kept in the background already follow the monitor, setting it
+        // again would make them rebuild their hosts and lose their history
+        if (m_view->monitor() != m_monitor) {
+            m_view->setMonitor(m_monitor);
+        }
 
-        setCentralWidget(m_view->widget());
+        QWidget *widget = m_view->widget();
+        if (m_viewStack->indexOf(widget) == -1) {
+            m_viewStack->addWidget(widget);
+        }
+        m_viewStack->setCurrentWidget(widget);
     }
 
     // update action-group
@@ -283,6 +383,8 @@ void MainWindow::setView(StatusView *view)
             break;
         }
     }
+
+    updateRendering();
 }
 
 void MainWindow::pauseView()
@@ -371,6 +473,7 @@ void MainWindow::updateSchedulerState(Monitor::SchedulerState state)
         }
 
         m_schedStatusWidget->setText(statusText.isEmpty() ? tr("Scheduler is online.") : statusText);
+        StartupTrace::mark(QStringLiteral("scheduler online"));
     } else
     {
         m_schedStatusWidget->setText(tr("Scheduler is offline."));
@@ -378,6 +481,7 @@ void MainWindow::updateSchedulerState(Monitor::SchedulerState state)
 
     m_activeJobs.clear();
     updateJobStats();
+    updateClusterActivity();
 }
 
 void MainWindow::updateJob(const Job &job)
@@ -385,9 +489,49 @@ void MainWindow::updateJob(const Job &job)
     if (job.isActive()) {
         m_activeJobs[job.id] = job;
         updateJobStats();
+        updateClusterActivity();
     } else if (job.isDone()) {
         m_activeJobs.remove(job.id);
         updateJobStats();
+        updateClusterActivity();
+    }
+}
+
+void MainWindow::updateClusterActivity()
+{
+    if (!m_activeJobs.isEmpty()) {
+        m_idleTimer->stop();
+        if (m_clusterIdle) {
+            m_clusterIdle = false;
+            updateRendering();
+        }
+    } else if (!m_clusterIdle && !m_idleTimer->isActive()) {
+        m_idleTimer->start();
+    }
+}
+
+void MainWindow::clusterBecameIdle()
+{
+    m_clusterIdle = true;
+    updateRendering();
+}
+
+void MainWindow::updateRendering()
+{
+    // Hidden or not, the monitor keeps feeding the job store and the aggregators
+    const bool hidden = !isVisible() || isMinimized();
+    FrameScheduler::instance()->setSuspended(hidden || m_clusterIdle);
+
+    // A hidden view doesn't need the jobs either, it catches up from the store when shown
+    if (!m_view) {
+        return;
+    }
+    if (hidden && !m_pausedWhileHidden && !m_view->isPaused()) {
+        m_pausedWhileHidden = true;
+        m_view->setPaused(true);
+    } else if (!hidden && m_pausedWhileHidden) {
+        m_pausedWhileHidden = false;
+        m_view->setPaused(false);
     }
 }
 
@@ -475,9 +619,32 @@ void MainWindow::handleViewModeActionTriggered(QAction *action)
 {
     const QString viewId = action->data().toString();
     Q_ASSERT(!viewId.isEmpty());
+    showView(viewId);
+}
+
+void MainWindow::showView(const QString &viewId)
+{
+    if (m_view && m_view->id() == viewId) {
+        return;
+    }
+
+    for (StatusView *view : std::as_const(m_backgroundViews)) {
+        if (view->id() == viewId) {
+            setView(view);
+            return;
+        }
+    }
+
     setView(StatusViewFactory::create(viewId, this));
 }
 
+void MainWindow::clearBackgroundViews()
+{
+    qDeleteAll(m_backgroundViews);
+    m_backgroundViews.clear();
+    m_pausedInBackground.clear();
+}
+
 // It's nasty that we have to hard-code the implementations of Monitor
 // But we can't just add a setMonitor() method because we require the host info manager
 void MainWindow::setTestModeEnabled(bool testMode)
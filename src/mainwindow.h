@@ -26,6 +26,7 @@
 
 #include <QMainWindow>
 #include <QPointer>
+#include <QSet>
 #include <QSystemTrayIcon>
 
 #include "monitor.h"
@@ -36,6 +37,8 @@ class StatusView;
 
 class QActionGroup;
 class QLabel;
+class QStackedWidget;
+class QTimer;
 
 class MainWindow
     : public QMainWindow
@@ -57,6 +60,9 @@ public:
 
 protected:
     void closeEvent(QCloseEvent *e) override;
+    void showEvent(QShowEvent *e) override;
+    void hideEvent(QHideEvent *e) override;
+    void changeEvent(QEvent *e) override;
 
 private slots:
     void pauseView();
@@ -72,6 +78,7 @@ private slots:
     void updateJobStats();
 
     void handleViewModeActionTriggered(QAction *action);
+    void clusterBecameIdle();
 
 private:
     void readSettings();
@@ -81,11 +88,27 @@ private:
     void setMonitor(Monitor *monitor);
     /// Takes ownership over @p view
     void setView(StatusView *view);
+    /// Switches to a recently used view if it is still around, creates a new one otherwise
+    void showView(const QString &viewId);
+    void clearBackgroundViews();
+    /// Starts the idle countdown once the last job finished, ends idleness with the next job
+    void updateClusterActivity();
+    /// Suspends rendering while the window is hidden or minimized, or the cluster is idle
+    void updateRendering();
 
     HostInfoManager *m_hostInfoManager;
     QPointer<Monitor> m_monitor;
     StatusView *m_view{nullptr};
+    /// Recently used views kept alive for switching back, most recent first
+    QList<StatusView *> m_backgroundViews;
+    /// Background views which were paused when they were hidden
+    QSet<StatusView *> m_pausedInBackground;
+    QStackedWidget *m_viewStack;
     QSystemTrayIcon* m_systemTrayIcon{nullptr};
+    /// The current view was paused because the window got hidden
+    bool m_pausedWhileHidden{false};
+    bool m_clusterIdle{false};
+    QTimer *m_idleTimer;
 
     QLabel *m_schedStatusWidget;
     QLabel *m_jobStatsWidget;
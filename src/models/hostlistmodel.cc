@@ -25,7 +25,7 @@
 #include <QApplication>
 #include <QPalette>
 
-#include <algorithm>
+#include <utility>
 
 HostListModel::HostListModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -44,22 +44,49 @@ void HostListModel::setMonitor(Monitor *monitor)
     }
 
     if (m_monitor) {
-        disconnect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
-        disconnect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        disconnectMonitor();
     }
 
     beginResetModel();
-    m_hostInfos.clear();
+    m_hosts.clear();
+    m_rowForHost.clear();
     m_monitor = monitor;
     fill();
     endResetModel();
 
+    if (m_monitor && m_updatesEnabled) {
+        connectMonitor();
+    }
+}
+
+void HostListModel::setUpdatesEnabled(bool enabled)
+{
+    if (m_updatesEnabled == enabled) {
+        return;
+    }
+
+    m_updatesEnabled = enabled;
     if (m_monitor) {
-        connect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
-        connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        if (enabled) {
+            connectMonitor();
+        } else {
+            disconnectMonitor();
+        }
     }
 }
 
+void HostListModel::connectMonitor()
+{
+    connect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
+    connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+}
+
+void HostListModel::disconnectMonitor()
+{
+    disconnect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
+    disconnect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+}
+
 QVariant HostListModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
@@ -96,11 +123,12 @@ QVariant HostListModel::headerData(int section, Qt::Orientation orientation, int
 
 QVariant HostListModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid()) {
+    const HostInfo *host = hostInfoForIndex(index);
+    if (!host) {
         return QVariant();
     }
 
-    const HostInfo info = hostInfoForIndex(index);
+    const HostInfo &info = *host;
     const int column = index.column();
     if (role == HostIdRole) {
         return info.id();
@@ -169,7 +197,7 @@ int HostListModel::columnCount(const QModelIndex &parent) const
 int HostListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return m_hostInfos.size();
+    return m_hosts.size();
 }
 
 QModelIndex HostListModel::parent(const QModelIndex &child) const
@@ -178,15 +206,69 @@ QModelIndex HostListModel::parent(const QModelIndex &child) const
     return QModelIndex();
 }
 
-HostInfo HostListModel::hostInfoForIndex(const QModelIndex &index) const
+const HostInfo *HostListModel::hostInfoForIndex(const QModelIndex &index) const
 {
-    return m_hostInfos.value(index.row());
+    // Hosts which went offline since are gone from the manager, the row stays until removeNodeById()
+    if (!m_monitor || !index.isValid() || index.row() >= m_hosts.size()) {
+        return nullptr;
+    }
+    return m_monitor->hostInfoManager()->find(m_hosts.at(index.row()).id);
 }
 
 QModelIndex HostListModel::indexForHostInfo(const HostInfo &info, int column) const
 {
-    const int i = m_hostInfos.indexOf(info);
-    return index(i, column);
+    return index(m_rowForHost.value(info.id(), -1), column);
+}
+
+HostListModel::HostValues HostListModel::hostValues(const HostInfo &info)
+{
+    HostValues values;
+    values.name = info.name();
+    values.ip = info.ip();
+    values.platform = info.platform();
+    values.features = info.features();
+    values.color = info.color().rgba();
+    values.protocol = info.protocol();
+    values.maxJobs = info.maxJobs();
+    values.speed = int(info.serverSpeed());
+    values.load = info.serverLoad();
+    values.noRemote = info.noRemote();
+    return values;
+}
+
+quint16 HostListModel::changedColumns(const HostValues &oldValues, const HostValues &newValues)
+{
+    quint16 changed = 0;
+    const auto check = [&changed](bool differs, int column) {
+        if (differs) {
+            changed |= 1 << column;
+        }
+    };
+    check(oldValues.name != newValues.name, ColumnName);
+    check(oldValues.noRemote != newValues.noRemote, ColumnNoRemote);
+    check(oldValues.color != newValues.color, ColumnColor);
+    check(oldValues.ip != newValues.ip, ColumnIP);
+    check(oldValues.platform != newValues.platform, ColumnPlatform);
+    check(oldValues.protocol != newValues.protocol, ColumnProtocol);
+    check(oldValues.features != newValues.features, ColumnFeatures);
+    check(oldValues.maxJobs != newValues.maxJobs, ColumnMaxJobs);
+    check(oldValues.speed != newValues.speed, ColumnSpeed);
+    check(oldValues.load != newValues.load, ColumnLoad);
+
+    // No remote also changes the colors of the whole row
+    if (changed & (1 << ColumnNoRemote)) {
+        changed = (1 << _ColumnCount) - 1;
+    }
+    return changed;
+}
+
+void HostListModel::appendHost(const HostInfo *info)
+{
+    HostRow row;
+    row.id = info->id();
+    row.values = hostValues(*info);
+    m_rowForHost.insert(info->id(), m_hosts.size());
+    m_hosts << row;
 }
 
 void HostListModel::checkNode(unsigned int hostid)
@@ -194,37 +276,57 @@ void HostListModel::checkNode(unsigned int hostid)
     Q_ASSERT(m_monitor);
 
     const HostInfo *info = m_monitor->hostInfoManager()->find(hostid);
+    const int row = m_rowForHost.value(hostid, -1);
     if (!info) {
+        if (row != -1) {
+            removeNodeById(hostid);
+        }
         return;
     }
 
-    const int index = m_hostInfos.indexOf(*info);
-    if (index != -1) {
+    if (row != -1) {
         if (info->isOffline()) {
             removeNodeById(hostid);
-        } else {
-            m_hostInfos[index] = *info;
-            emit dataChanged(indexForHostInfo(*info, 0), indexForHostInfo(*info, _ColumnCount - 1));
+            return;
+        }
+
+        HostRow &hostRow = m_hosts[row];
+        HostValues values = hostValues(*info);
+        const quint16 changed = changedColumns(hostRow.values, values);
+        hostRow.values = std::move(values);
+
+        // One signal per run of changed columns, the unchanged ones in between are left out
+        for (int first = 0; first < _ColumnCount; ++first) {
+            if (!(changed & (1 << first))) {
+                continue;
+            }
+            int last = first;
+            while (last + 1 < _ColumnCount && (changed & (1 << (last + 1)))) {
+                ++last;
+            }
+            emit dataChanged(index(row, first), index(row, last));
+            first = last;
         }
     } else if (!info->isOffline()) {
-        beginInsertRows(QModelIndex(), m_hostInfos.size(), m_hostInfos.size());
-        m_hostInfos << *info;
+        beginInsertRows(QModelIndex(), m_hosts.size(), m_hosts.size());
+        appendHost(info);
         endInsertRows();
     }
 }
 
 void HostListModel::removeNodeById(unsigned int hostId)
 {
-    auto it = std::find_if(m_hostInfos.begin(), m_hostInfos.end(),
-        [hostId](const HostInfo &info) {
-            return info.id() == hostId;
-        });
-    if (it == m_hostInfos.end()) {
+    const int row = m_rowForHost.value(hostId, -1);
+    if (row == -1) {
         return;
     }
-    int index = std::distance(m_hostInfos.begin(), it);
-    beginRemoveRows(QModelIndex(), index, index);
-    m_hostInfos.erase(it);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rowForHost.remove(hostId);
+    m_hosts.remove(row);
+    for (int i = row; i < m_hosts.size(); ++i) {
+        m_rowForHost[m_hosts.at(i).id] = i;
+    }
     endRemoveRows();
 }
 
@@ -234,14 +336,10 @@ void HostListModel::fill()
         return;
     }
 
-    const HostInfoManager *manager = m_monitor->hostInfoManager();
-    const HostInfoManager::HostMap hosts(manager->hostMap());
-    foreach(int hostid, hosts.keys()) {
-        const HostInfo *info = m_monitor->hostInfoManager()->find(hostid);
-        if (!info) {
-            continue;
-        }
-
-        m_hostInfos << *info;
+    const HostInfoManager::HostMap hosts(m_monitor->hostInfoManager()->hostMap());
+    m_hosts.reserve(hosts.size());
+    m_rowForHost.reserve(hosts.size());
+    for (auto it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
+        appendHost(*it);
     }
 }
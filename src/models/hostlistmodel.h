@@ -22,6 +22,7 @@
 #define ICEMON_HOSTLISTMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QPointer>
 
 #include "hostinfo.h"
@@ -67,18 +68,57 @@ public:
     Monitor *monitor() const;
     void setMonitor(Monitor *monitor);
 
-    HostInfo hostInfoForIndex(const QModelIndex &index) const;
+    const HostInfo *hostInfoForIndex(const QModelIndex &index) const;
     QModelIndex indexForHostInfo(const HostInfo &info, int column) const;
 
-private Q_SLOTS:
+    bool updatesEnabled() const { return m_updatesEnabled; }
+    /// Stops following the monitor until enabled again, use checkNode() and removeNodeById() to catch up
+    void setUpdatesEnabled(bool enabled);
+
+public Q_SLOTS:
     void checkNode(HostId hostId);
     void removeNodeById(HostId hostId);
 
 private:
+    void connectMonitor();
+    void disconnectMonitor();
+
+    /// The values of a host as the views currently show them
+    struct HostValues
+    {
+        QString name;
+        QString ip;
+        QString platform;
+        QString features;
+        QRgb color{0};
+        int protocol{0};
+        unsigned int maxJobs{0};
+        int speed{0};
+        unsigned int load{0};
+        bool noRemote{false};
+    };
+
+    /**
+     * A row only knows the id of its host, the HostInfo is looked up in the
+     * HostInfoManager of the monitor each time. It deletes the hosts going
+     * offline, also while the model doesn't follow the monitor. The shown
+     * values tell which columns changed.
+     */
+    struct HostRow
+    {
+        HostId id{0};
+        HostValues values;
+    };
+
+    static HostValues hostValues(const HostInfo &info);
+    static quint16 changedColumns(const HostValues &oldValues, const HostValues &newValues);
+    void appendHost(const HostInfo *info);
     void fill();
 
     QPointer<Monitor> m_monitor;
-    QVector<HostInfo> m_hostInfos;
+    QVector<HostRow> m_hosts;
+    QHash<HostId, int> m_rowForHost;
+    bool m_updatesEnabled{true};
 };
 
 #endif // ICEMON_HOSTLISTMODEL_H
@@ -20,6 +20,7 @@
 
 #include "joblistmodel.h"
 
+#include "framescheduler.h"
 #include "hostinfo.h"
 #include "monitor.h"
 
@@ -29,8 +30,15 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QCoreApplication>
+#include <QtAlgorithms>
 
 #include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+
+// Removals with more ranges are done within a single layout change
+static const int MaxRemoveRanges = 16;
 
 static QString formatByteSize(unsigned int value)
 {
@@ -48,6 +56,29 @@ static QString formatByteSize(unsigned int value)
     return QCoreApplication::tr("%1 %2").arg(QLocale::system().toString(value), units[unit]);
 }
 
+/**
+ * Columns whose contents differ between two versions of the same job
+ */
+static quint16 changedColumns(const Job &oldJob, const Job &newJob)
+{
+    quint16 changed = 0;
+    const auto check = [&changed](bool differs, int column) {
+        if (differs) {
+            changed |= 1 << column;
+        }
+    };
+    check(oldJob.fileName != newJob.fileName, JobListModel::JobColumnFilename);
+    check(oldJob.client != newJob.client, JobListModel::JobColumnClient);
+    check(oldJob.server != newJob.server, JobListModel::JobColumnServer);
+    check(oldJob.state != newJob.state, JobListModel::JobColumnState);
+    check(oldJob.real_msec != newJob.real_msec, JobListModel::JobColumnReal);
+    check(oldJob.user_msec != newJob.user_msec, JobListModel::JobColumnUser);
+    check(oldJob.pfaults != newJob.pfaults, JobListModel::JobColumnFaults);
+    check(oldJob.in_uncompressed != newJob.in_uncompressed, JobListModel::JobColumnSizeIn);
+    check(oldJob.out_uncompressed != newJob.out_uncompressed, JobListModel::JobColumnSizeOut);
+    return changed;
+}
+
 /**
  * Remove some of the parts of a file path
  *
@@ -78,10 +109,21 @@ static QString trimFilePath(const QString &filePath, int numberOfFilePathParts)
 
 JobListModel::JobListModel(QObject *parent)
     : QAbstractListModel(parent)
-    , m_expireTimer(new QTimer(this))
+    , m_texts(16384)
+    , m_compactTimer(new QTimer(this))
 {
-    connect(m_expireTimer, SIGNAL(timeout()),
-            this, SLOT(slotExpireFinishedJobs()));
+    m_expireCallback = FrameScheduler::instance()->addCallback(this, [this]() { slotExpireFinishedJobs(); },
+                                                               1000, false);
+
+    m_compactTimer->setSingleShot(true);
+    m_compactTimer->setInterval(500);
+    connect(m_compactTimer, SIGNAL(timeout()),
+            this, SLOT(slotCompact()));
+}
+
+JobListModel::~JobListModel()
+{
+    unsubscribe();
 }
 
 Monitor *JobListModel::monitor() const
@@ -96,38 +138,169 @@ void JobListModel::setMonitor(Monitor *monitor)
     }
 
     if (m_monitor) {
-        disconnect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
+        disconnectUpdates();
+        disconnect(m_monitor->jobStore(), SIGNAL(cleared()), this, SLOT(clear()));
+        disconnect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(hostUpdated(HostId)));
     }
     m_monitor = monitor;
+    m_hostNames.clear();
     if (m_monitor) {
+        connectUpdates();
+        // Also while paused, the names shown and sorted by are no job state
+        connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(hostUpdated(HostId)));
+        if (isProjection()) {
+            connect(m_monitor->jobStore(), SIGNAL(cleared()), this, SLOT(clear()));
+            loadHistory();
+        }
+    }
+}
+
+void JobListModel::setUpdatesEnabled(bool enabled)
+{
+    if (m_updatesEnabled == enabled) {
+        return;
+    }
+
+    if (m_monitor && !enabled) {
+        disconnectUpdates();
+    }
+    m_updatesEnabled = enabled;
+    if (m_monitor && enabled) {
+        connectUpdates();
+    }
+}
+
+void JobListModel::updateJobs(const QVector<Job> &jobs)
+{
+    for (const Job &job : jobs) {
+        updateJob(job);
+    }
+}
+
+void JobListModel::connectUpdates()
+{
+    if (isProjection()) {
+        subscribe();
+    } else if (m_updatesEnabled) {
         connect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
     }
 }
 
+void JobListModel::disconnectUpdates()
+{
+    if (isProjection()) {
+        unsubscribe();
+    } else {
+        disconnect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
+    }
+}
+
 void JobListModel::setHostId(unsigned int hostId)
 {
     if (m_hostId == hostId) {
         return;
     }
 
+    unsubscribe();
     m_hostId = hostId;
     clear();
+    subscribe();
+    loadHistory();
+}
+
+JobStore::Index JobListModel::storeIndex() const
+{
+    return m_jobType == RemoteJobs ? JobStore::ByServer : JobStore::ByClient;
+}
+
+void JobListModel::subscribe()
+{
+    if (m_monitor && m_updatesEnabled && isProjection() && m_hostId) {
+        m_monitor->jobStore()->addListener(storeIndex(), m_hostId, this);
+    }
+}
+
+void JobListModel::unsubscribe()
+{
+    if (m_monitor && isProjection() && m_hostId) {
+        m_monitor->jobStore()->removeListener(storeIndex(), m_hostId, this);
+    }
+}
+
+void JobListModel::loadHistory()
+{
+    if (!m_monitor || !isProjection() || !m_hostId) {
+        return;
+    }
+
+    const JobStore *store = m_monitor->jobStore();
+    const QVector<unsigned int> jobIds = store->jobsForHost(storeIndex(), m_hostId);
+    if (jobIds.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_jobs.size(), m_jobs.size() + jobIds.size() - 1);
+    m_jobs.reserve(m_jobs.size() + jobIds.size());
+    for (unsigned int jobId : jobIds) {
+        const Job *job = store->find(jobId);
+        m_slotForJob.insert(jobId, m_firstSlot + m_jobs.size());
+        m_jobs << JobRow(*job);
+        indexFileName(m_jobs.last());
+        m_memoryUsage += memoryCost(*job);
+    }
+    endInsertRows();
+
+    if (m_memoryLimit > 0 && m_memoryUsage > m_memoryLimit) {
+        evictOldestJobs();
+    }
+}
+
+void JobListModel::jobStored(const Job &job)
+{
+    updateJob(job);
+}
+
+void JobListModel::jobDropped(unsigned int jobId)
+{
+    if (rowForJobId(jobId) != -1) {
+        removeItemById(jobId);
+    }
 }
 
 void JobListModel::updateJob(const Job &job)
 {
-    const int index = m_jobs.indexOf(job);
-    if (index != -1) {
-        m_jobs[index] = job;
-        emit dataChanged(indexForJob(job, 0), indexForJob(job, _JobColumnCount - 1));
+    const int row = rowForJobId(job.id);
+    if (row != -1) {
+        JobRow &jobRow = m_jobs[row];
+        const quint16 changed = changedColumns(jobRow.job, job);
+        m_memoryUsage += memoryCost(job) - memoryCost(jobRow.job);
+        if (changed & (1 << JobColumnFilename)) {
+            unindexFileName(jobRow);
+            jobRow.job.fileName = job.fileName;
+            indexFileName(jobRow);
+        }
+        jobRow.job = job;
+        uncacheTexts(job.id, changed);
+        if (changed) {
+            // Only the span of columns which actually changed
+            const int first = qCountTrailingZeroBits(changed);
+            const int last = 15 - qCountLeadingZeroBits(changed);
+            emit dataChanged(index(row, first), index(row, last));
+        }
     } else {
-        if (m_hostId && m_jobType == RemoteJobs && job.server != m_hostId)
-            return;
-        if (m_hostId && m_jobType == LocalJobs && job.client != m_hostId)
+        if (!acceptsJob(job)) {
             return;
+        }
         beginInsertRows(QModelIndex(), m_jobs.size(), m_jobs.size());
-        m_jobs << job;
+        m_slotForJob.insert(job.id, m_firstSlot + m_jobs.size());
+        m_jobs << JobRow(job);
+        indexFileName(m_jobs.last());
+        m_memoryUsage += memoryCost(job);
         endInsertRows();
+
+        if (m_memoryLimit > 0 && m_memoryUsage > m_memoryLimit) {
+            evictOldestJobs();
+        }
     }
 
     const bool finished = (job.state == Job::Finished || job.state == Job::Failed);
@@ -136,12 +309,139 @@ void JobListModel::updateJob(const Job &job)
     }
 }
 
+void JobListModel::hostUpdated(HostId hostId)
+{
+    // Most updates are load changes, only a new name touches the rows
+    const QString name = m_monitor->hostInfoManager()->nameForHost(hostId);
+    auto it = m_hostNames.find(hostId);
+    if (it != m_hostNames.end() && *it == name) {
+        return;
+    }
+    if (it == m_hostNames.end()) {
+        it = m_hostNames.insert(hostId, name);
+    } else {
+        *it = name;
+    }
+
+    // Rows shown before the host was known have its placeholder
+    for (int row = 0; row < m_jobs.size(); ++row) {
+        const Job &job = m_jobs.at(row).job;
+        quint16 changed = 0;
+        if (job.client == hostId) {
+            changed |= 1 << JobColumnClient;
+        }
+        if (job.server == hostId) {
+            changed |= 1 << JobColumnServer;
+        }
+        if (changed) {
+            uncacheTexts(job.id, changed);
+            const int first = qCountTrailingZeroBits(changed);
+            const int last = 15 - qCountLeadingZeroBits(changed);
+            emit dataChanged(index(row, first), index(row, last));
+        }
+    }
+}
+
+bool JobListModel::acceptsJob(const Job &job) const
+{
+    if (m_hostId && m_jobType == RemoteJobs && job.server != m_hostId)
+        return false;
+    if (m_hostId && m_jobType == LocalJobs && job.client != m_hostId)
+        return false;
+    return true;
+}
+
+void JobListModel::setJobs(const QVector<Job> &jobs)
+{
+    beginResetModel();
+    clearJobs();
+    m_jobs.reserve(jobs.size());
+    for (const Job &job : jobs) {
+        if (!acceptsJob(job)) {
+            continue;
+        }
+        m_slotForJob.insert(job.id, m_firstSlot + m_jobs.size());
+        m_jobs << JobRow(job);
+        indexFileName(m_jobs.last());
+        m_memoryUsage += memoryCost(job);
+    }
+    endResetModel();
+
+    if (m_expireDuration >= 0) {
+        for (const JobRow &row : std::as_const(m_jobs)) {
+            if (row.job.isDone()) {
+                expireItem(row.job);
+            }
+        }
+    }
+    if (m_memoryLimit > 0 && m_memoryUsage > m_memoryLimit) {
+        evictOldestJobs();
+    }
+}
+
 void JobListModel::clear()
 {
     beginResetModel();
+    clearJobs();
+    endResetModel();
+}
+
+void JobListModel::clearJobs()
+{
     m_jobs.clear();
+    m_texts.clear();
+    m_paths.clear();
+    m_pathIds.clear();
+    m_trigrams.clear();
+    m_slotForJob.clear();
+    m_firstSlot = 0;
+    m_removedJobs.clear();
+    m_compactTimer->stop();
     m_finishedJobs.clear();
-    endResetModel();
+    FrameScheduler::instance()->setCallbackEnabled(m_expireCallback, false);
+    m_memoryUsage = 0;
+}
+
+void JobListModel::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = qMax<qint64>(0, bytes);
+    if (m_memoryLimit > 0 && m_memoryUsage > m_memoryLimit) {
+        evictOldestJobs();
+    }
+}
+
+qint64 JobListModel::memoryCost(const Job &job)
+{
+    // The row itself, the strings of the job and roughly what the index
+    // entry of a row takes, the display texts are cached separately
+    return sizeof(JobRow) + (job.fileName.size() + job.lang.size()) * sizeof(QChar) + 64;
+}
+
+void JobListModel::evictOldestJobs()
+{
+    // Drop a batch down to 90% of the limit so this doesn't happen on every insert
+    const qint64 target = m_memoryLimit / 10 * 9;
+    qint64 usage = m_memoryUsage;
+    int count = 0;
+    while (count < m_jobs.size() && usage > target) {
+        usage -= memoryCost(m_jobs.at(count).job);
+        ++count;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    for (int row = 0; row < count; ++row) {
+        m_slotForJob.remove(m_jobs.at(row).job.id);
+        unindexFileName(m_jobs.at(row));
+        uncacheTexts(m_jobs.at(row).job.id);
+    }
+    // Removing from the front of a Qt 6 container doesn't move the other rows
+    m_jobs.erase(m_jobs.begin(), m_jobs.begin() + count);
+    m_firstSlot += count;
+    m_memoryUsage = usage;
+    endRemoveRows();
 }
 
 int JobListModel::columnCount(const QModelIndex &parent) const
@@ -150,15 +450,132 @@ int JobListModel::columnCount(const QModelIndex &parent) const
     return _JobColumnCount;
 }
 
-Job JobListModel::jobForIndex(const QModelIndex &index) const
+const Job &JobListModel::jobForIndex(const QModelIndex &index) const
+{
+    static const Job invalidJob;
+    if (index.row() < 0 || index.row() >= m_jobs.size()) {
+        return invalidJob;
+    }
+    return m_jobs.at(index.row()).job;
+}
+
+QModelIndex JobListModel::indexForJob(const Job &job, int column) const
 {
-    return m_jobs.value(index.row());
+    const int row = rowForJobId(job.id);
+    return row == -1 ? QModelIndex() : index(row, column);
+}
+
+static quint64 trigramKey(const QChar *c)
+{
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | c[2].unicode();
+}
+
+void JobListModel::indexFileName(JobRow &row)
+{
+    const QString &path = row.job.fileName;
+    if (path.isEmpty()) {
+        row.pathId = -1;
+        return;
+    }
+
+    auto it = m_pathIds.constFind(path);
+    if (it == m_pathIds.constEnd()) {
+        const int pathId = m_paths.size();
+        PathEntry entry;
+        entry.folded = path.toCaseFolded();
+        // Path ids only grow, so appending keeps every postings list sorted
+        for (int i = 0; i + 3 <= entry.folded.size(); ++i) {
+            QVector<int> &postings = m_trigrams[trigramKey(entry.folded.constData() + i)];
+            if (postings.isEmpty() || postings.last() != pathId) {
+                postings.append(pathId);
+            }
+        }
+        m_paths.append(entry);
+        it = m_pathIds.insert(path, pathId);
+    }
+
+    row.pathId = *it;
+    m_paths[row.pathId].jobs.append(row.job.id);
 }
 
-QModelIndex JobListModel::indexForJob(const Job &job, int column)
+void JobListModel::unindexFileName(const JobRow &row)
 {
-    const int i = m_jobs.indexOf(job);
-    return index(i, column);
+    if (row.pathId >= 0) {
+        m_paths[row.pathId].jobs.removeOne(row.job.id);
+    }
+}
+
+QVector<unsigned int> JobListModel::jobsMatchingFileName(const QString &fragment) const
+{
+    const QString folded = fragment.toCaseFolded();
+
+    QVector<int> candidates;
+    if (folded.size() < 3) {
+        // Too short for a trigram, the path table is still much smaller than the job list
+        candidates.resize(m_paths.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+    } else {
+        QVector<const QVector<int> *> lists;
+        for (int i = 0; i + 3 <= folded.size(); ++i) {
+            const auto it = m_trigrams.constFind(trigramKey(folded.constData() + i));
+            if (it == m_trigrams.constEnd()) {
+                return {};
+            }
+            lists.append(&*it);
+        }
+
+        // Intersect, starting with the shortest postings list
+        std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+            return a->size() < b->size();
+        });
+        candidates = *lists.first();
+        for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+            QVector<int> intersection;
+            std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                                  lists.at(i)->constBegin(), lists.at(i)->constEnd(),
+                                  std::back_inserter(intersection));
+            candidates = std::move(intersection);
+        }
+    }
+
+    // The trigrams may occur in a different order, check the candidates
+    QVector<unsigned int> jobs;
+    for (int pathId : std::as_const(candidates)) {
+        const PathEntry &entry = m_paths.at(pathId);
+        if (!entry.jobs.isEmpty() && entry.folded.contains(folded)) {
+            jobs += entry.jobs;
+        }
+    }
+    return jobs;
+}
+
+bool JobListModel::fileNameMatches(const QModelIndex &index, const QString &fragment) const
+{
+    if (fragment.isEmpty()) {
+        return true;
+    }
+    if (index.row() < 0 || index.row() >= m_jobs.size()) {
+        return false;
+    }
+
+    const int pathId = m_jobs.at(index.row()).pathId;
+    return pathId >= 0 && m_paths.at(pathId).folded.contains(fragment.toCaseFolded());
+}
+
+int JobListModel::rowForJobId(unsigned int jobId) const
+{
+    const auto it = m_slotForJob.constFind(jobId);
+    if (it == m_slotForJob.constEnd()) {
+        return -1;
+    }
+
+    int row = int(*it - m_firstSlot);
+    for (const auto &gap : m_slotGaps) {
+        if (gap.first < *it) {
+            row -= gap.second;
+        }
+    }
+    return row;
 }
 
 QVariant JobListModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -196,32 +613,29 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
         return QVariant();
     }
 
-    const Job job = jobForIndex(index);
+    if (index.row() >= m_jobs.size()) {
+        return QVariant();
+    }
+
+    const JobRow &row = m_jobs.at(index.row());
     const int column = index.column();
-    Q_ASSERT(m_monitor);
-    const HostInfoManager *manager = m_monitor->hostInfoManager();
     if (role == Qt::DisplayRole) {
         switch (column) {
         case JobColumnID:
-            return job.id;
+            return row.job.id;
         case JobColumnFilename:
-            return trimFilePath(job.fileName, m_numberOfFilePathParts);
         case JobColumnClient:
-            return manager->nameForHost(job.client);
         case JobColumnServer:
-            return manager->nameForHost(job.server);
         case JobColumnState:
-            return job.stateAsString();
+        case JobColumnSizeIn:
+        case JobColumnSizeOut:
+            return displayText(row, column);
         case JobColumnReal:
-            return job.real_msec;
+            return row.job.real_msec;
         case JobColumnUser:
-            return job.user_msec;
+            return row.job.user_msec;
         case JobColumnFaults:
-            return job.pfaults;
-        case JobColumnSizeIn:
-            return formatByteSize(job.in_uncompressed);
-        case JobColumnSizeOut:
-            return formatByteSize(job.out_uncompressed);
+            return row.job.pfaults;
         default:
             break;
         }
@@ -246,6 +660,59 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
+QString JobListModel::displayText(const JobRow &row, int column) const
+{
+    const quint64 key = textKey(row.job.id, column);
+    if (const QString *text = m_texts.object(key)) {
+        return *text;
+    }
+
+    Q_ASSERT(m_monitor);
+    const HostInfoManager *manager = m_monitor->hostInfoManager();
+    const Job &job = row.job;
+    bool cacheable = true;
+    QString text;
+    switch (column) {
+    case JobColumnFilename:
+        text = trimFilePath(job.fileName, m_numberOfFilePathParts);
+        break;
+    case JobColumnClient:
+        // Unknown hosts may show up later, don't keep their placeholder
+        text = manager->nameForHost(job.client);
+        cacheable = manager->find(job.client);
+        break;
+    case JobColumnServer:
+        text = manager->nameForHost(job.server);
+        cacheable = manager->find(job.server);
+        break;
+    case JobColumnState:
+        text = job.stateAsString();
+        break;
+    case JobColumnSizeIn:
+        text = formatByteSize(job.in_uncompressed);
+        break;
+    case JobColumnSizeOut:
+        text = formatByteSize(job.out_uncompressed);
+        break;
+    default:
+        break;
+    }
+
+    if (cacheable) {
+        m_texts.insert(key, new QString(text));
+    }
+    return text;
+}
+
+void JobListModel::uncacheTexts(unsigned int jobId, quint16 columns)
+{
+    for (int column = 0; column < _JobColumnCount; ++column) {
+        if (columns & (1 << column)) {
+            m_texts.remove(textKey(jobId, column));
+        }
+    }
+}
+
 QModelIndex JobListModel::parent(const QModelIndex &child) const
 {
     Q_UNUSED(child);
@@ -270,14 +737,16 @@ void JobListModel::slotExpireFinishedJobs()
             break;
         }
 
-        unsigned int jobId = (*it).jobId;
-        removeItemById(jobId);
+        m_removedJobs.append((*it).jobId);
     }
 
     m_finishedJobs.erase(m_finishedJobs.begin(), it);
 
+    // All jobs expired within this tick are removed in one batch
+    slotCompact();
+
     if (m_finishedJobs.empty()) {
-        m_expireTimer->stop();
+        FrameScheduler::instance()->setCallbackEnabled(m_expireCallback, false);
     }
 }
 
@@ -288,14 +757,143 @@ void JobListModel::removeItem(const Job &job)
 
 void JobListModel::removeItemById(unsigned int jobId)
 {
-    QVector<Job>::iterator it = std::find_if(m_jobs.begin(), m_jobs.end(),
-        [jobId](const Job &job) {
-            return job.id == jobId;
-        });
-    int index = std::distance(m_jobs.begin(), it);
-    beginRemoveRows(QModelIndex(), index, index);
-    m_jobs.erase(it);
-    endRemoveRows();
+    // Only marked here, slotCompact() removes the rows in batches
+    m_removedJobs.append(jobId);
+    if (!m_compactTimer->isActive()) {
+        m_compactTimer->start();
+    }
+}
+
+void JobListModel::slotCompact()
+{
+    m_compactTimer->stop();
+
+    QVector<int> rows;
+    rows.reserve(m_removedJobs.size());
+    for (unsigned int jobId : std::as_const(m_removedJobs)) {
+        const int row = rowForJobId(jobId);
+        if (row != -1) {
+            rows.append(row);
+        }
+    }
+    m_removedJobs.clear();
+
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    for (int row : std::as_const(rows)) {
+        m_memoryUsage -= memoryCost(m_jobs.at(row).job);
+        unindexFileName(m_jobs.at(row));
+        uncacheTexts(m_jobs.at(row).job.id);
+    }
+
+    // Contiguous ranges as pairs of first and last row
+    QVector<QPair<int, int>> ranges;
+    for (int row : std::as_const(rows)) {
+        if (!ranges.isEmpty() && ranges.last().second == row - 1) {
+            ranges.last().second = row;
+        } else {
+            ranges.append(qMakePair(row, row));
+        }
+    }
+
+    if (ranges.size() > MaxRemoveRanges) {
+        removeScatteredRows(rows);
+        return;
+    }
+
+    // One removal per range, back to front so the rows in front stay valid.
+    // The slots behind a removed range are only renumbered once at the end,
+    // until then the gaps keep rowForJobId() right for the handlers.
+    for (int i = ranges.size() - 1; i >= 0; --i) {
+        const int first = ranges.at(i).first;
+        const int last = ranges.at(i).second;
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row) {
+            m_slotForJob.remove(m_jobs.at(row).job.id);
+        }
+        m_jobs.erase(m_jobs.begin() + first, m_jobs.begin() + last + 1);
+        if (first == 0) {
+            m_firstSlot += last + 1;
+        } else {
+            m_slotGaps.append(qMakePair(m_firstSlot + first, last - first + 1));
+        }
+        endRemoveRows();
+    }
+    m_slotGaps.clear();
+
+    // Rows in front of the first range behind the front didn't move
+    const int front = ranges.first().first == 0 ? ranges.first().second + 1 : 0;
+    const int firstMoved = front ? (ranges.size() > 1 ? ranges.at(1).first : -1) : ranges.first().first;
+    if (firstMoved != -1) {
+        renumberRows(firstMoved - front);
+    }
+}
+
+void JobListModel::renumberRows(int first)
+{
+    for (int row = first; row < m_jobs.size(); ++row) {
+        m_slotForJob[m_jobs.at(row).job.id] = m_firstSlot + row;
+    }
+}
+
+void JobListModel::removeScatteredRows(const QVector<int> &rows)
+{
+    // Too many single removals for attached views and proxies, remove
+    // everything within one layout change instead
+    m_layoutRemovedJobs.reserve(rows.size());
+    for (int row : rows) {
+        m_layoutRemovedJobs.append(m_jobs.at(row).job.id);
+    }
+    emit layoutAboutToBeChanged();
+
+    for (unsigned int jobId : std::as_const(m_layoutRemovedJobs)) {
+        m_slotForJob.remove(jobId);
+    }
+
+    QVector<int> newRows(m_jobs.size());
+    int removed = 0;
+    int next = 0;
+    for (int row = 0; row < m_jobs.size(); ++row) {
+        if (removed < rows.size() && rows.at(removed) == row) {
+            newRows[row] = -1;
+            ++removed;
+        } else {
+            newRows[row] = next++;
+        }
+    }
+
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &idx : from) {
+        const int row = newRows.value(idx.row(), -1);
+        to.append(row == -1 ? QModelIndex() : index(row, idx.column()));
+    }
+
+    int row = 0;
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+                                [&newRows, &row](const JobRow &) { return newRows.at(row++) == -1; }),
+                 m_jobs.end());
+
+    // Rows removed from the front just move the first slot, everything
+    // behind the first gap has to be renumbered
+    int prefix = 0;
+    while (prefix < rows.size() && rows.at(prefix) == prefix) {
+        ++prefix;
+    }
+    m_firstSlot += prefix;
+    if (prefix < rows.size()) {
+        renumberRows(rows.at(prefix) - prefix);
+    }
+
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+    m_layoutRemovedJobs.clear();
 }
 
 void JobListModel::expireItem(const Job &job)
@@ -308,9 +906,7 @@ void JobListModel::expireItem(const Job &job)
     const uint currentTime = QDateTime::currentDateTime().toSecsSinceEpoch();
     m_finishedJobs.push_back(FinishedJob(currentTime, job.id));
 
-    if (!m_expireTimer->isActive()) {
-        m_expireTimer->start(1000);
-    }
+    FrameScheduler::instance()->setCallbackEnabled(m_expireCallback, true);
 }
 
 JobListSortFilterProxyModel::JobListSortFilterProxyModel(QObject *parent)
@@ -327,8 +923,8 @@ bool JobListSortFilterProxyModel::lessThan(const QModelIndex &left, const QModel
     // Sort file sizes correctly, the view shows them already formatted in a way that wouldn't be correctly numerically
     // compared.
     const JobListModel *model = static_cast<JobListModel *>(sourceModel());
-    Job jobLeft = model->jobForIndex(left);
-    Job jobRight = model->jobForIndex(right);
+    const Job &jobLeft = model->jobForIndex(left);
+    const Job &jobRight = model->jobForIndex(right);
     unsigned int leftValue = left.column() == JobListModel::JobColumnSizeIn ? jobLeft.in_uncompressed : jobLeft.out_uncompressed;
     unsigned int rightValue = right.column() == JobListModel::JobColumnSizeIn ? jobRight.in_uncompressed : jobRight.out_uncompressed;
     return leftValue < rightValue;
@@ -22,8 +22,11 @@
 #define JOBLISTMODEL_H
 
 #include "job.h"
+#include "jobstore.h"
 
 #include <QAbstractItemModel>
+#include <QCache>
+#include <QHash>
 #include <QSortFilterProxyModel>
 #include <QPointer>
 #include <QVector>
@@ -31,8 +34,17 @@
 class Monitor;
 class QTimer;
 
+/**
+ * List of jobs
+ *
+ * With the AllJobs type the model follows every job of the monitor.
+ * Otherwise it is a projection of the jobs of one host out of the job
+ * store of the monitor, it starts with the retained history of the host
+ * and only receives the events of that host.
+ */
 class JobListModel
     : public QAbstractListModel
+    , private JobStore::Listener
 {
     Q_OBJECT
 
@@ -60,6 +72,7 @@ public:
     };
 
     explicit JobListModel(QObject *parent = nullptr);
+    ~JobListModel() override;
 
     Monitor *monitor() const;
     void setMonitor(Monitor *monitor);
@@ -72,32 +85,144 @@ public:
         m_expireDuration = duration;
     }
 
+    qint64 memoryLimit() const {
+        return m_memoryLimit;
+    }
+
+    /**
+     * Limits the estimated memory used by the jobs to @p bytes, 0 for no limit.
+     * The oldest rows are dropped in batches once the limit is exceeded.
+     */
+    void setMemoryLimit(qint64 bytes);
+
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QModelIndex parent(const QModelIndex &child) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
-    Job jobForIndex(const QModelIndex &index) const;
-    QModelIndex indexForJob(const Job &job, int column);
+    /// Replaces all rows with @p jobs in a single model reset
+    void setJobs(const QVector<Job> &jobs);
+    /// Applies the current state of @p jobs, adding the ones which belong to this model
+    void updateJobs(const QVector<Job> &jobs);
+
+    bool updatesEnabled() const { return m_updatesEnabled; }
+    /// Stops following the monitor until enabled again, use updateJobs() to catch up
+    void setUpdatesEnabled(bool enabled);
+
+    const Job &jobForIndex(const QModelIndex &index) const;
+    QModelIndex indexForJob(const Job &job, int column) const;
+
+    /// Ids of all jobs whose file path contains @p fragment, ignoring case
+    QVector<unsigned int> jobsMatchingFileName(const QString &fragment) const;
+    bool fileNameMatches(const QModelIndex &index, const QString &fragment) const;
+
+    /**
+     * Ids of the jobs removed by the current layout change, empty for any
+     * other layout change. Only valid between layoutAboutToBeChanged() and
+     * layoutChanged(), proxies can drop just these instead of re-sorting.
+     */
+    const QVector<unsigned int> &removedJobIds() const { return m_layoutRemovedJobs; }
 
     void setHostId(unsigned int hostId);
     unsigned int hostId() const { return m_hostId; }
+    /// Needs to be set before the monitor
     void setJobType(JobType type) { m_jobType = type; }
     JobType jobType() const { return m_jobType; }
 
 private Q_SLOTS:
     void slotExpireFinishedJobs();
+    void slotCompact();
 
     void updateJob(const Job &job);
+    void hostUpdated(HostId hostId);
     void clear();
 
 private:
-    QVector<Job> m_jobs;
+    void jobStored(const Job &job) override;
+    void jobDropped(unsigned int jobId) override;
+
+    bool isProjection() const { return m_jobType != AllJobs; }
+    JobStore::Index storeIndex() const;
+    void subscribe();
+    void unsubscribe();
+    void connectUpdates();
+    void disconnectUpdates();
+    void loadHistory();
+    void clearJobs();
+    bool acceptsJob(const Job &job) const;
+
+    struct JobRow
+    {
+        explicit JobRow(const Job &job = Job())
+            : job(job) {}
+
+        Job job;
+        int pathId{-1};
+    };
+
+    QVector<JobRow> m_jobs;
+
+    /**
+     * Display texts by job id and column. Only the rows asked for, mostly the
+     * visible ones, end up here, so the cache is bounded instead of holding
+     * the texts of every row.
+     */
+    mutable QCache<quint64, QString> m_texts;
+    /// Last known name of each host, the client and server columns change with it
+    QHash<HostId, QString> m_hostNames;
+
+    static quint64 textKey(unsigned int jobId, int column)
+    {
+        return (quint64(jobId) << 8) | quint64(column);
+    }
+
+    QString displayText(const JobRow &row, int column) const;
+    void uncacheTexts(unsigned int jobId, quint16 columns = 0xffff);
+
+    /**
+     * Every distinct file path is stored once. The trigrams of the case
+     * folded paths map to the sorted ids of the paths containing them.
+     */
+    struct PathEntry
+    {
+        QString folded;
+        QVector<unsigned int> jobs;
+    };
+
+    QVector<PathEntry> m_paths;
+    QHash<QString, int> m_pathIds;
+    QHash<quint64, QVector<int>> m_trigrams;
+
+    void indexFileName(JobRow &row);
+    void unindexFileName(const JobRow &row);
+
+    static qint64 memoryCost(const Job &job);
+    void evictOldestJobs();
+
+    /**
+     * Position of each job in m_jobs, the row of a job is its slot minus
+     * m_firstSlot. Removing rows from the front only moves m_firstSlot, all
+     * other removals are done in batches by slotCompact().
+     */
+    QHash<unsigned int, qint64> m_slotForJob;
+    qint64 m_firstSlot{0};
+    /// While slotCompact() removes ranges: first slot and size of the ranges not renumbered yet
+    QVector<QPair<qint64, int>> m_slotGaps;
+
+    /// Jobs which are removed with the next compaction
+    QVector<unsigned int> m_removedJobs;
+    /// Jobs removed within the current layout change, see removedJobIds()
+    QVector<unsigned int> m_layoutRemovedJobs;
+    QTimer *m_compactTimer;
+
+    int rowForJobId(unsigned int jobId) const;
 
     void expireItem(const Job &job);
     void removeItem(const Job &job);
     void removeItemById(unsigned int jobId);
+    void removeScatteredRows(const QVector<int> &rows);
+    void renumberRows(int first);
 
     QPointer<Monitor> m_monitor;
 
@@ -120,6 +245,9 @@ private:
      */
     int m_expireDuration{-1};
 
+    qint64 m_memoryLimit{0};
+    qint64 m_memoryUsage{0};
+
     struct FinishedJob
     {
         explicit FinishedJob(uint _time = 0, uint _jobId = 0)
@@ -133,9 +261,11 @@ private:
     /// List with job ids that are expired
     FinishedJobs m_finishedJobs;
 
-    QTimer *m_expireTimer;
+    /// Frame scheduler callback of slotExpireFinishedJobs(), while jobs are waiting to expire
+    int m_expireCallback;
     JobType m_jobType{AllJobs};
     unsigned int m_hostId{0};
+    bool m_updatesEnabled{true};
 };
 
 class JobListSortFilterProxyModel
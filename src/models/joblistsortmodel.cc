@@ -0,0 +1,610 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "joblistsortmodel.h"
+
+#include "joblistmodel.h"
+
+#include <utility>
+
+bool JobListSortModel::Key::operator<(const Key &other) const
+{
+    if (number != other.number) {
+        return number < other.number;
+    }
+    const int cmp = text.compare(other.text);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return jobId < other.jobId;
+}
+
+bool JobListSortModel::Key::operator==(const Key &other) const
+{
+    return number == other.number && jobId == other.jobId && text == other.text;
+}
+
+JobListSortModel::JobListSortModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+void JobListSortModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (QAbstractItemModel *oldModel = this->sourceModel()) {
+        disconnect(oldModel, nullptr, this, nullptr);
+    }
+
+    beginResetModel();
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    m_jobsModel = qobject_cast<JobListModel *>(sourceModel);
+    Q_ASSERT(!sourceModel || m_jobsModel);
+    rebuild();
+    endResetModel();
+
+    if (!m_jobsModel) {
+        return;
+    }
+
+    connect(m_jobsModel, &QAbstractItemModel::rowsInserted, this, &JobListSortModel::sourceRowsInserted);
+    connect(m_jobsModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &JobListSortModel::sourceRowsAboutToBeRemoved);
+    connect(m_jobsModel, &QAbstractItemModel::dataChanged, this, &JobListSortModel::sourceDataChanged);
+    connect(m_jobsModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &JobListSortModel::sourceLayoutAboutToBeChanged);
+    connect(m_jobsModel, &QAbstractItemModel::layoutChanged, this, &JobListSortModel::sourceLayoutChanged);
+    connect(m_jobsModel, &QAbstractItemModel::modelAboutToBeReset, this, &JobListSortModel::beginResetModel);
+    connect(m_jobsModel, &QAbstractItemModel::modelReset, this, &JobListSortModel::sourceModelReset);
+}
+
+QModelIndex JobListSortModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!m_jobsModel || !proxyIndex.isValid()) {
+        return QModelIndex();
+    }
+
+    const int node = select(rankForProxyRow(proxyIndex.row()));
+    if (node < 0) {
+        return QModelIndex();
+    }
+
+    Job job;
+    job.id = m_nodes.at(node).key.jobId;
+    return m_jobsModel->indexForJob(job, proxyIndex.column());
+}
+
+QModelIndex JobListSortModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!m_jobsModel || !sourceIndex.isValid()) {
+        return QModelIndex();
+    }
+
+    const int node = m_nodeForJob.value(m_jobsModel->jobForIndex(sourceIndex).id, -1);
+    if (node < 0) {
+        return QModelIndex();
+    }
+    return index(proxyRow(rank(node)), sourceIndex.column());
+}
+
+QModelIndex JobListSortModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex JobListSortModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int JobListSortModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : size(m_root);
+}
+
+int JobListSortModel::columnCount(const QModelIndex &parent) const
+{
+    return (parent.isValid() || !m_jobsModel) ? 0 : m_jobsModel->columnCount();
+}
+
+void JobListSortModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == m_sortColumn && order == m_sortOrder) {
+        return;
+    }
+
+    beginLayoutChange();
+    m_sortColumn = qMax(0, column);
+    m_sortOrder = order;
+    rebuild();
+    endLayoutChange();
+}
+
+void JobListSortModel::setFileNameFilter(const QString &fragment)
+{
+    if (fragment == m_fileNameFilter) {
+        return;
+    }
+
+    // Without a reset, so the selection and the scroll position survive
+    const QString oldFolded = m_fileNameFilter.toCaseFolded();
+    const QString folded = fragment.toCaseFolded();
+    beginLayoutChange();
+    m_fileNameFilter = fragment;
+
+    // A longer fragment only matches jobs the shorter one matched, and a
+    // shorter one all of those, so only one of the passes is usually needed
+    if (!oldFolded.contains(folded)) {
+        const QList<unsigned int> jobIds = m_nodeForJob.keys();
+        Job job;
+        for (unsigned int jobId : jobIds) {
+            job.id = jobId;
+            if (!m_jobsModel->fileNameMatches(m_jobsModel->indexForJob(job, 0), fragment)) {
+                removeJobNode(jobId);
+            }
+        }
+    }
+    if (!folded.contains(oldFolded) && m_jobsModel) {
+        if (fragment.isEmpty()) {
+            for (int row = 0; row < m_jobsModel->rowCount(); ++row) {
+                if (!m_nodeForJob.contains(m_jobsModel->jobForIndex(m_jobsModel->index(row, 0)).id)) {
+                    insertNode(createNode(keyForSourceRow(row)));
+                }
+            }
+        } else {
+            const QVector<unsigned int> jobIds = m_jobsModel->jobsMatchingFileName(fragment);
+            Job job;
+            for (unsigned int jobId : jobIds) {
+                job.id = jobId;
+                const QModelIndex sourceIndex = m_jobsModel->indexForJob(job, 0);
+                if (sourceIndex.isValid() && !m_nodeForJob.contains(jobId)) {
+                    insertNode(createNode(keyForSourceRow(sourceIndex.row())));
+                }
+            }
+        }
+    }
+
+    endLayoutChange();
+}
+
+void JobListSortModel::removeJobNode(unsigned int jobId)
+{
+    const int node = m_nodeForJob.value(jobId, -1);
+    if (node >= 0) {
+        m_nodeForJob.remove(jobId);
+        detachNode(node);
+        m_freeNodes.append(node);
+    }
+}
+
+bool JobListSortModel::acceptsSourceRow(int sourceRow) const
+{
+    return m_fileNameFilter.isEmpty()
+        || m_jobsModel->fileNameMatches(m_jobsModel->index(sourceRow, 0), m_fileNameFilter);
+}
+
+void JobListSortModel::insertSourceRow(int sourceRow)
+{
+    const Key key = keyForSourceRow(sourceRow);
+    const int rank = countLess(key);
+    const int proxy = m_sortOrder == Qt::AscendingOrder ? rank : size(m_root) - rank;
+
+    beginInsertRows(QModelIndex(), proxy, proxy);
+    insertNode(createNode(key));
+    endInsertRows();
+}
+
+JobListSortModel::Key JobListSortModel::keyForSourceRow(int sourceRow) const
+{
+    const QModelIndex sourceIndex = m_jobsModel->index(sourceRow, m_sortColumn);
+    const Job &job = m_jobsModel->jobForIndex(sourceIndex);
+
+    Key key;
+    key.jobId = job.id;
+    switch (m_sortColumn) {
+    case JobListModel::JobColumnID:
+        key.number = job.id;
+        break;
+    case JobListModel::JobColumnReal:
+        key.number = job.real_msec;
+        break;
+    case JobListModel::JobColumnUser:
+        key.number = job.user_msec;
+        break;
+    case JobListModel::JobColumnFaults:
+        key.number = job.pfaults;
+        break;
+    case JobListModel::JobColumnSizeIn:
+        key.number = job.in_uncompressed;
+        break;
+    case JobListModel::JobColumnSizeOut:
+        key.number = job.out_uncompressed;
+        break;
+    default:
+        // Text columns sort by what is displayed, the model caches it
+        key.text = m_jobsModel->data(sourceIndex).toString();
+        break;
+    }
+    return key;
+}
+
+void JobListSortModel::updateNode(int node)
+{
+    Node &n = m_nodes[node];
+    n.size = 1 + size(n.left) + size(n.right);
+    if (n.left >= 0) {
+        m_nodes[n.left].parent = node;
+    }
+    if (n.right >= 0) {
+        m_nodes[n.right].parent = node;
+    }
+}
+
+void JobListSortModel::split(int tree, const Key &key, int &left, int &right)
+{
+    // left gets all keys less than key, right the rest
+    if (tree < 0) {
+        left = right = -1;
+        return;
+    }
+
+    if (m_nodes.at(tree).key < key) {
+        int rest;
+        split(m_nodes.at(tree).right, key, rest, right);
+        m_nodes[tree].right = rest;
+        left = tree;
+    } else {
+        int rest;
+        split(m_nodes.at(tree).left, key, left, rest);
+        m_nodes[tree].left = rest;
+        right = tree;
+    }
+    m_nodes[tree].parent = -1;
+    updateNode(tree);
+}
+
+int JobListSortModel::merge(int left, int right)
+{
+    if (left < 0) {
+        return right;
+    }
+    if (right < 0) {
+        return left;
+    }
+
+    if (m_nodes.at(left).priority > m_nodes.at(right).priority) {
+        const int merged = merge(m_nodes.at(left).right, right);
+        m_nodes[left].right = merged;
+        updateNode(left);
+        return left;
+    } else {
+        const int merged = merge(left, m_nodes.at(right).left);
+        m_nodes[right].left = merged;
+        updateNode(right);
+        return right;
+    }
+}
+
+int JobListSortModel::countLess(const Key &key) const
+{
+    int count = 0;
+    int node = m_root;
+    while (node >= 0) {
+        const Node &n = m_nodes.at(node);
+        if (n.key < key) {
+            count += size(n.left) + 1;
+            node = n.right;
+        } else {
+            node = n.left;
+        }
+    }
+    return count;
+}
+
+int JobListSortModel::rank(int node) const
+{
+    int result = size(m_nodes.at(node).left);
+    for (int parent = m_nodes.at(node).parent; parent >= 0; node = parent, parent = m_nodes.at(node).parent) {
+        if (m_nodes.at(parent).right == node) {
+            result += size(m_nodes.at(parent).left) + 1;
+        }
+    }
+    return result;
+}
+
+int JobListSortModel::select(int rank) const
+{
+    int node = m_root;
+    while (node >= 0) {
+        const Node &n = m_nodes.at(node);
+        const int leftSize = size(n.left);
+        if (rank < leftSize) {
+            node = n.left;
+        } else if (rank == leftSize) {
+            return node;
+        } else {
+            rank -= leftSize + 1;
+            node = n.right;
+        }
+    }
+    return -1;
+}
+
+int JobListSortModel::createNode(const Key &key)
+{
+    // xorshift, the priorities only need to look random
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node n;
+    n.key = key;
+    n.priority = m_seed;
+
+    int node;
+    if (!m_freeNodes.isEmpty()) {
+        node = m_freeNodes.takeLast();
+        m_nodes[node] = n;
+    } else {
+        node = m_nodes.size();
+        m_nodes.append(n);
+    }
+    m_nodeForJob.insert(key.jobId, node);
+    return node;
+}
+
+void JobListSortModel::insertNode(int node)
+{
+    Node &n = m_nodes[node];
+    n.left = n.right = n.parent = -1;
+    n.size = 1;
+
+    int left, right;
+    split(m_root, m_nodes.at(node).key, left, right);
+    m_root = merge(merge(left, node), right);
+    m_nodes[m_root].parent = -1;
+}
+
+void JobListSortModel::detachNode(int node)
+{
+    const Node n = m_nodes.at(node);
+    const int replacement = merge(n.left, n.right);
+    if (replacement >= 0) {
+        m_nodes[replacement].parent = n.parent;
+    }
+
+    if (n.parent < 0) {
+        m_root = replacement;
+    } else {
+        Node &parent = m_nodes[n.parent];
+        if (parent.left == node) {
+            parent.left = replacement;
+        } else {
+            parent.right = replacement;
+        }
+        for (int p = n.parent; p >= 0; p = m_nodes.at(p).parent) {
+            m_nodes[p].size--;
+        }
+    }
+}
+
+void JobListSortModel::rebuild()
+{
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_nodeForJob.clear();
+    m_root = -1;
+
+    if (!m_jobsModel) {
+        return;
+    }
+
+    if (m_fileNameFilter.isEmpty()) {
+        const int count = m_jobsModel->rowCount();
+        m_nodes.reserve(count);
+        for (int row = 0; row < count; ++row) {
+            insertNode(createNode(keyForSourceRow(row)));
+        }
+        return;
+    }
+
+    // Only the matches from the file name index, no scan over all jobs
+    const QVector<unsigned int> jobIds = m_jobsModel->jobsMatchingFileName(m_fileNameFilter);
+    m_nodes.reserve(jobIds.size());
+    Job job;
+    for (unsigned int jobId : jobIds) {
+        job.id = jobId;
+        const QModelIndex sourceIndex = m_jobsModel->indexForJob(job, 0);
+        if (sourceIndex.isValid()) {
+            insertNode(createNode(keyForSourceRow(sourceIndex.row())));
+        }
+    }
+}
+
+int JobListSortModel::proxyRow(int rank) const
+{
+    return m_sortOrder == Qt::AscendingOrder ? rank : size(m_root) - 1 - rank;
+}
+
+int JobListSortModel::rankForProxyRow(int row) const
+{
+    return m_sortOrder == Qt::AscendingOrder ? row : size(m_root) - 1 - row;
+}
+
+void JobListSortModel::beginLayoutChange()
+{
+    emit layoutAboutToBeChanged();
+
+    // Remember persistent indexes by job, the rows may all change
+    m_savedPersistentIndexes = persistentIndexList();
+    m_savedJobIds.clear();
+    m_savedJobIds.reserve(m_savedPersistentIndexes.size());
+    for (const QModelIndex &index : std::as_const(m_savedPersistentIndexes)) {
+        const int node = select(rankForProxyRow(index.row()));
+        m_savedJobIds.append(node < 0 ? 0 : m_nodes.at(node).key.jobId);
+    }
+}
+
+void JobListSortModel::endLayoutChange()
+{
+    QModelIndexList to;
+    to.reserve(m_savedPersistentIndexes.size());
+    for (int i = 0; i < m_savedPersistentIndexes.size(); ++i) {
+        const int node = m_nodeForJob.value(m_savedJobIds.at(i), -1);
+        to.append(node < 0 ? QModelIndex() : index(proxyRow(rank(node)), m_savedPersistentIndexes.at(i).column()));
+    }
+    changePersistentIndexList(m_savedPersistentIndexes, to);
+    m_savedPersistentIndexes.clear();
+    m_savedJobIds.clear();
+
+    emit layoutChanged();
+}
+
+void JobListSortModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    for (int row = first; row <= last; ++row) {
+        if (acceptsSourceRow(row)) {
+            insertSourceRow(row);
+        }
+    }
+}
+
+void JobListSortModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const auto removeNode = [this](int sourceRow) {
+        removeJobNode(m_jobsModel->jobForIndex(m_jobsModel->index(sourceRow, 0)).id);
+    };
+
+    if (first == last) {
+        const int node = m_nodeForJob.value(m_jobsModel->jobForIndex(m_jobsModel->index(first, 0)).id, -1);
+        if (node < 0) {
+            return;
+        }
+        const int proxy = proxyRow(rank(node));
+        beginRemoveRows(QModelIndex(), proxy, proxy);
+        removeNode(first);
+        endRemoveRows();
+        return;
+    }
+
+    // A range of source rows is scattered all over the sorted rows
+    beginLayoutChange();
+    for (int row = first; row <= last; ++row) {
+        removeNode(row);
+    }
+    endLayoutChange();
+}
+
+void JobListSortModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (!topLeft.isValid() || topLeft.parent().isValid()) {
+        return;
+    }
+
+    const bool sortKeyChanged = topLeft.column() <= m_sortColumn && m_sortColumn <= bottomRight.column();
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const unsigned int jobId = m_jobsModel->jobForIndex(m_jobsModel->index(row, 0)).id;
+        const int node = m_nodeForJob.value(jobId, -1);
+
+        // A changed file name may change whether the job passes the filter
+        if (!m_fileNameFilter.isEmpty()
+            && topLeft.column() <= JobListModel::JobColumnFilename && JobListModel::JobColumnFilename <= bottomRight.column()) {
+            const bool accepted = acceptsSourceRow(row);
+            if (node < 0 && accepted) {
+                insertSourceRow(row);
+                continue;
+            } else if (node >= 0 && !accepted) {
+                const int proxy = proxyRow(rank(node));
+                beginRemoveRows(QModelIndex(), proxy, proxy);
+                m_nodeForJob.remove(jobId);
+                detachNode(node);
+                m_freeNodes.append(node);
+                endRemoveRows();
+                continue;
+            }
+        }
+
+        if (node < 0) {
+            continue;
+        }
+
+        if (sortKeyChanged) {
+            const Key key = keyForSourceRow(row);
+            if (!(key == m_nodes.at(node).key)) {
+                // Final position among the other rows, then one move there
+                const int count = size(m_root);
+                const int oldRank = rank(node);
+                int newRank = countLess(key);
+                if (m_nodes.at(node).key < key) {
+                    --newRank;
+                }
+                const int from = proxyRow(oldRank);
+                const int to = m_sortOrder == Qt::AscendingOrder ? newRank : count - 1 - newRank;
+
+                const bool moved = from != to
+                    && beginMoveRows(QModelIndex(), from, from, QModelIndex(), to < from ? to : to + 1);
+                detachNode(node);
+                m_nodes[node].key = key;
+                insertNode(node);
+                if (moved) {
+                    endMoveRows();
+                }
+            }
+        }
+
+        const int proxy = proxyRow(rank(node));
+        emit dataChanged(index(proxy, topLeft.column()), index(proxy, bottomRight.column()));
+    }
+}
+
+void JobListSortModel::sourceLayoutAboutToBeChanged()
+{
+    beginLayoutChange();
+
+    // Rows removed in a batch only leave the tree, the order of the others
+    // doesn't change and the nodes don't depend on the source rows
+    const QVector<unsigned int> &removedJobIds = m_jobsModel->removedJobIds();
+    m_removingJobs = !removedJobIds.isEmpty();
+    for (unsigned int jobId : removedJobIds) {
+        removeJobNode(jobId);
+    }
+}
+
+void JobListSortModel::sourceLayoutChanged()
+{
+    if (!std::exchange(m_removingJobs, false)) {
+        rebuild();
+    }
+    endLayoutChange();
+}
+
+void JobListSortModel::sourceModelReset()
+{
+    rebuild();
+    endResetModel();
+}
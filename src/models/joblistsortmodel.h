@@ -0,0 +1,130 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef JOBLISTSORTMODEL_H
+#define JOBLISTSORTMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QHash>
+#include <QVector>
+
+class JobListModel;
+
+/**
+ * Sorted view of a JobListModel
+ *
+ * The jobs are kept in an order-statistics tree (a treap with subtree
+ * sizes) keyed by the value of the sort column and the job id. Mapping a
+ * row in either direction is O(log n), an updated job is repositioned
+ * with a single row move and an inserted job costs a single row insertion.
+ */
+class JobListSortModel
+    : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit JobListSortModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    QString fileNameFilter() const { return m_fileNameFilter; }
+    /// Only shows jobs whose file path contains @p fragment, empty to show all
+    void setFileNameFilter(const QString &fragment);
+
+private Q_SLOTS:
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void sourceLayoutAboutToBeChanged();
+    void sourceLayoutChanged();
+    void sourceModelReset();
+
+private:
+    struct Key
+    {
+        quint64 number{0};
+        QString text;
+        unsigned int jobId{0};
+
+        bool operator<(const Key &other) const;
+        bool operator==(const Key &other) const;
+    };
+
+    struct Node
+    {
+        Key key;
+        quint32 priority{0};
+        int left{-1};
+        int right{-1};
+        int parent{-1};
+        int size{1};
+    };
+
+    Key keyForSourceRow(int sourceRow) const;
+    bool acceptsSourceRow(int sourceRow) const;
+    void insertSourceRow(int sourceRow);
+
+    int size(int node) const { return node < 0 ? 0 : m_nodes.at(node).size; }
+    void updateNode(int node);
+    void split(int tree, const Key &key, int &left, int &right);
+    int merge(int left, int right);
+    int countLess(const Key &key) const;
+    int rank(int node) const;
+    int select(int rank) const;
+
+    int createNode(const Key &key);
+    void insertNode(int node);
+    void detachNode(int node);
+    void removeJobNode(unsigned int jobId);
+    void rebuild();
+
+    int proxyRow(int rank) const;
+    int rankForProxyRow(int row) const;
+
+    void beginLayoutChange();
+    void endLayoutChange();
+
+    JobListModel *m_jobsModel{nullptr};
+    int m_sortColumn{0};
+    Qt::SortOrder m_sortOrder{Qt::AscendingOrder};
+    QString m_fileNameFilter;
+
+    QVector<Node> m_nodes;
+    QVector<int> m_freeNodes;
+    QHash<unsigned int, int> m_nodeForJob;
+    int m_root{-1};
+    quint32 m_seed{0x9e3779b9};
+
+    QModelIndexList m_savedPersistentIndexes;
+    QVector<unsigned int> m_savedJobIds;
+    /// The current source layout change only removes jobs
+    bool m_removingJobs{false};
+};
+
+#endif
@@ -20,12 +20,35 @@
 
 #include "monitor.h"
 
+#include "capacityrollups.h"
+#include "hostutilization.h"
+#include "jobstore.h"
+#include "sessiondetector.h"
 #include "statusview.h"
 
 Monitor::Monitor(HostInfoManager *manager, QObject *parent)
     : QObject(parent)
     , m_hostInfoManager(manager)
+    , m_jobStore(new JobStore(this))
+    , m_capacityRollups(new CapacityRollups(manager, this))
+    , m_hostUtilization(new HostUtilization(manager, this))
+    , m_sessionDetector(new SessionDetector(this))
 {
+    // Connected first, so the store is up to date for every other receiver
+    connect(this, &Monitor::jobUpdated, m_jobStore, &JobStore::update);
+    connect(this, &Monitor::nodeUpdated, m_jobStore, &JobStore::hostUpdated);
+    connect(this, &Monitor::nodeRemoved, m_jobStore, &JobStore::hostRemoved);
+
+    connect(this, &Monitor::jobUpdated, m_capacityRollups, &CapacityRollups::updateJob);
+    connect(this, &Monitor::nodeUpdated, m_capacityRollups, &CapacityRollups::updateHost);
+    connect(this, &Monitor::nodeRemoved, m_capacityRollups, &CapacityRollups::removeHost);
+
+    connect(this, &Monitor::jobUpdated, m_hostUtilization, &HostUtilization::updateJob);
+    connect(this, &Monitor::nodeUpdated, m_hostUtilization, &HostUtilization::updateHost);
+    connect(this, &Monitor::nodeRemoved, m_hostUtilization, &HostUtilization::removeHost);
+
+    connect(this, &Monitor::jobUpdated, m_sessionDetector, &SessionDetector::updateJob);
+    connect(this, &Monitor::nodeRemoved, m_sessionDetector, &SessionDetector::removeHost);
 }
 
 QByteArray Monitor::currentNetname() const
@@ -71,8 +94,3 @@ void Monitor::setSchedulerState(SchedulerState state)
     m_schedulerState = state;
     emit schedulerStateChanged(state);
 }
-
-QList<Job> Monitor::jobHistory() const
-{
-    return QList<Job>();
-}
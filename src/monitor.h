@@ -29,6 +29,10 @@
 class StatusView;
 class HostInfoManager;
 class Job;
+class JobStore;
+class CapacityRollups;
+class HostUtilization;
+class SessionDetector;
 
 /**
  * Abstract base class for monitoring a icecream-like scheduler
@@ -59,9 +63,15 @@ public
 
     SchedulerState schedulerState() const;
 
-    virtual QList<Job> jobHistory() const;
-
     HostInfoManager *hostInfoManager() const { return m_hostInfoManager; }
+    /// All jobs seen by this monitor, updated before jobUpdated() reaches the views
+    JobStore *jobStore() const { return m_jobStore; }
+    /// Active jobs and capacity per platform over time
+    CapacityRollups *capacityRollups() const { return m_capacityRollups; }
+    /// Busy job slots per host over the last hour
+    HostUtilization *hostUtilization() const { return m_hostUtilization; }
+    /// Build sessions and their achieved parallelism per client
+    SessionDetector *sessionDetector() const { return m_sessionDetector; }
 
 protected:
     void setSchedulerState(SchedulerState online);
@@ -75,6 +85,10 @@ Q_SIGNALS:
 
 private:
     HostInfoManager *m_hostInfoManager;
+    JobStore *m_jobStore;
+    CapacityRollups *m_capacityRollups;
+    HostUtilization *m_hostUtilization;
+    SessionDetector *m_sessionDetector;
     QByteArray m_currentNetname;
     QByteArray m_currentSchedname;
     uint m_currentSchedport{0};
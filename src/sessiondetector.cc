@@ -0,0 +1,212 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sessiondetector.h"
+
+#include "job.h"
+
+#include <QDateTime>
+
+#include <iterator>
+
+namespace {
+
+const qint64 SessionGap = 30 * 1000;
+const int MaxSessionsPerClient = 20;
+const int ProfileBuckets = 120;
+const qint64 InitialProfileBucket = 1000;
+/// Jobs without any event for this long are taken as ended
+const qint64 MaxJobSilence = 60 * 60 * 1000;
+/// How often to look for such jobs
+const qint64 ExpiryInterval = 60 * 1000;
+
+}
+
+double SessionDetector::Session::parallelism() const
+{
+    const qint64 wall = wallMsecs();
+    return wall > 0 ? double(busyMsecs) / wall : running;
+}
+
+SessionDetector::SessionDetector(QObject *parent)
+    : QObject(parent)
+{
+}
+
+qint64 SessionDetector::gapMsecs()
+{
+    return SessionGap;
+}
+
+QVector<SessionDetector::Session> SessionDetector::sessions(HostId client) const
+{
+    QVector<Session> sessions = m_sessions.value(client);
+
+    // Account for the time since the last job event of the current session
+    if (!sessions.isEmpty() && !sessions.last().isIdle()) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        integrate(sessions.last(), now);
+        sessions.last().end = now;
+    }
+    return sessions;
+}
+
+void SessionDetector::updateJob(const Job &job)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const JobPhase phase = job.state == Job::WaitingForCS ? Waiting : Running;
+    if (now - m_lastExpiry > ExpiryInterval) {
+        expireStaleJobs(now);
+    }
+
+    auto it = m_jobs.find(job.id);
+    if (it == m_jobs.end()) {
+        // Nothing to learn from jobs which were already done when we first saw them
+        if (job.isDone() || job.state == Job::Idle || !job.client) {
+            return;
+        }
+
+        Session &session = currentSession(job.client, now);
+        integrate(session, now);
+        ++session.jobs;
+        if (job.state == Job::LocalOnly) {
+            ++session.localJobs;
+        }
+        ++(phase == Waiting ? session.waiting : session.running);
+        session.end = now;
+        m_jobs.insert(job.id, TrackedJob{job.client, job.server, phase, job.state == Job::LocalOnly, now});
+        return;
+    }
+
+    if (job.isDone()) {
+        Session &session = m_sessions[it->client].last();
+        session.cpuMsecs += job.user_msec + job.sys_msec;
+        if (job.state == Job::Failed) {
+            ++session.failedJobs;
+        }
+        endJob(it, now);
+        return;
+    }
+
+    // A session with jobs in flight is always the current one of its client
+    Session &session = m_sessions[it->client].last();
+    integrate(session, now);
+    session.end = now;
+    it->lastSeen = now;
+    if (job.server) {
+        it->server = job.server;
+    }
+
+    if (phase != it->phase) {
+        --(it->phase == Waiting ? session.waiting : session.running);
+        ++(phase == Waiting ? session.waiting : session.running);
+        it->phase = phase;
+    }
+    if (job.state == Job::LocalOnly && !it->local) {
+        ++session.localJobs;
+        it->local = true;
+    }
+}
+
+void SessionDetector::removeHost(HostId hostid)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        it = (it->client == hostid || it->server == hostid) ? endJob(it, now) : std::next(it);
+    }
+}
+
+void SessionDetector::clear()
+{
+    m_sessions.clear();
+    m_jobs.clear();
+}
+
+SessionDetector::TrackedJobs::iterator SessionDetector::endJob(TrackedJobs::iterator it, qint64 now)
+{
+    // A session with jobs in flight is always the current one of its client
+    Session &session = m_sessions[it->client].last();
+    integrate(session, now);
+    session.end = now;
+    --(it->phase == Waiting ? session.waiting : session.running);
+    return m_jobs.erase(it);
+}
+
+void SessionDetector::expireStaleJobs(qint64 now)
+{
+    m_lastExpiry = now;
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        it = (now - it->lastSeen > MaxJobSilence) ? endJob(it, now) : std::next(it);
+    }
+}
+
+SessionDetector::Session &SessionDetector::currentSession(HostId client, qint64 now)
+{
+    QVector<Session> &sessions = m_sessions[client];
+    if (sessions.isEmpty() || (sessions.last().isIdle() && now - sessions.last().end > SessionGap)) {
+        if (sessions.size() >= MaxSessionsPerClient) {
+            sessions.removeFirst();
+        }
+
+        Session session;
+        session.client = client;
+        session.start = now;
+        session.end = now;
+        session.lastChange = now;
+        session.profileBucketMsecs = InitialProfileBucket;
+        sessions.append(session);
+    }
+    return sessions.last();
+}
+
+void SessionDetector::integrate(Session &session, qint64 now)
+{
+    const qint64 elapsed = now - session.lastChange;
+    if (elapsed <= 0) {
+        return;
+    }
+
+    session.busyMsecs += quint64(session.running) * elapsed;
+    session.waitMsecs += quint64(session.waiting) * elapsed;
+
+    if (session.running > 0) {
+        // Keep the profile at a fixed size by merging neighbouring buckets
+        const qint64 to = now - session.start;
+        while (to > session.profileBucketMsecs * ProfileBuckets) {
+            QVector<quint64> merged((session.profile.size() + 1) / 2, 0);
+            for (int i = 0; i < session.profile.size(); ++i) {
+                merged[i / 2] += session.profile.at(i);
+            }
+            session.profile = merged;
+            session.profileBucketMsecs *= 2;
+        }
+
+        qint64 from = session.lastChange - session.start;
+        while (from < to) {
+            const int bucket = int(from / session.profileBucketMsecs);
+            const qint64 end = qMin(to, (bucket + 1) * session.profileBucketMsecs);
+            if (session.profile.size() <= bucket) {
+                session.profile.resize(bucket + 1);
+            }
+            session.profile[bucket] += quint64(session.running) * (end - from);
+            from = end;
+        }
+    }
+
+    session.lastChange = now;
+}
@@ -0,0 +1,122 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_SESSIONDETECTOR_H
+#define ICEMON_SESSIONDETECTOR_H
+
+#include "types.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QVector>
+
+class Job;
+
+/**
+ * Groups the jobs of each client into build sessions
+ *
+ * A session ends once the client had no jobs running or waiting for a
+ * while. The detector only looks at each job event once and keeps the
+ * totals of a session up to date as it goes. Jobs whose end is never seen,
+ * because their host went away or the message got lost, are ended when the
+ * host is removed or after an hour without news.
+ */
+class SessionDetector
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Session
+    {
+        HostId client{0};
+        /// First and last activity, in msecs since the epoch
+        qint64 start{0};
+        qint64 end{0};
+
+        int jobs{0};
+        int localJobs{0};
+        int failedJobs{0};
+
+        /// User and system time of the finished jobs
+        quint64 cpuMsecs{0};
+        /// Job msecs spent compiling or waiting for a compile server
+        quint64 busyMsecs{0};
+        quint64 waitMsecs{0};
+
+        /// Busy job msecs per bucket, the buckets widen as the session grows
+        QVector<quint64> profile;
+        qint64 profileBucketMsecs{0};
+
+        int running{0};
+        int waiting{0};
+        qint64 lastChange{0};
+
+        qint64 wallMsecs() const { return end - start; }
+        /// Average number of jobs running at the same time
+        double parallelism() const;
+        double localFraction() const { return jobs ? double(localJobs) / jobs : 0.0; }
+        bool isIdle() const { return running == 0 && waiting == 0; }
+    };
+
+    explicit SessionDetector(QObject *parent = nullptr);
+
+    /// Time without jobs after which a new session starts
+    static qint64 gapMsecs();
+
+    QList<HostId> clients() const { return m_sessions.keys(); }
+    /// Sessions of @p client, the oldest first and the current one last
+    QVector<Session> sessions(HostId client) const;
+
+public Q_SLOTS:
+    void updateJob(const Job &job);
+    /// Ends the jobs of @p hostid, as client or as compile server
+    void removeHost(HostId hostid);
+    void clear();
+
+private:
+    enum JobPhase {
+        Waiting,
+        Running
+    };
+
+    struct TrackedJob
+    {
+        HostId client;
+        HostId server;
+        JobPhase phase;
+        bool local;
+        /// Time of the last event of the job
+        qint64 lastSeen;
+    };
+    using TrackedJobs = QHash<unsigned int, TrackedJob>;
+
+    Session &currentSession(HostId client, qint64 now);
+    static void integrate(Session &session, qint64 now);
+    /// Takes the job out of its session as of @p now
+    TrackedJobs::iterator endJob(TrackedJobs::iterator it, qint64 now);
+    void expireStaleJobs(qint64 now);
+
+    QHash<HostId, QVector<Session>> m_sessions;
+    /// Jobs which are waiting or running
+    TrackedJobs m_jobs;
+    qint64 m_lastExpiry{0};
+};
+
+#endif // ICEMON_SESSIONDETECTOR_H
@@ -0,0 +1,93 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "startuptrace.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QWidget>
+
+namespace {
+
+QElapsedTimer s_clock;
+bool s_enabled = false;
+
+/**
+ * Marks a step on the first paint event of the watched widget, then goes away
+ */
+class FirstPaintWatcher
+    : public QObject
+{
+public:
+    FirstPaintWatcher(QWidget *widget, const QString &step)
+        : QObject(widget)
+        , m_step(step)
+    {
+        widget->installEventFilter(this);
+    }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            watched->removeEventFilter(this);
+            StartupTrace::mark(m_step);
+            deleteLater();
+        }
+        return false;
+    }
+
+private:
+    QString m_step;
+};
+
+}
+
+void StartupTrace::start()
+{
+    s_clock.start();
+}
+
+bool StartupTrace::isEnabled()
+{
+    return s_enabled;
+}
+
+void StartupTrace::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+void StartupTrace::mark(const QString &step)
+{
+    if (!s_enabled) {
+        return;
+    }
+
+    qInfo().noquote() << QStringLiteral("startup: %1 ms %2").arg(s_clock.elapsed(), 6).arg(step);
+}
+
+void StartupTrace::markFirstPaint(QWidget *widget, const QString &step)
+{
+    if (!s_enabled || !widget) {
+        return;
+    }
+
+    new FirstPaintWatcher(widget, step);
+}
@@ -0,0 +1,41 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_STARTUPTRACE_H
+#define ICEMON_STARTUPTRACE_H
+
+class QString;
+class QWidget;
+
+/**
+ * Milliseconds from the start of the process to the steps of startup,
+ * printed when icemon runs with --startup-trace
+ */
+namespace StartupTrace {
+/// Starts the clock, call first thing in main()
+void start();
+
+bool isEnabled();
+void setEnabled(bool enabled);
+
+void mark(const QString &step);
+/// Marks @p step when @p widget is painted for the first time
+void markFirstPaint(QWidget *widget, const QString &step);
+}
+
+#endif // ICEMON_STARTUPTRACE_H
@@ -25,6 +25,7 @@
 
 #include "hostinfo.h"
 #include "job.h"
+#include "jobstore.h"
 
 #include <QDebug>
 #include <QTime>
@@ -55,9 +56,7 @@ void StatusView::setMonitor(Monitor *monitor)
     }
 
     if (m_monitor) {
-        disconnect(m_monitor.data(), &Monitor::jobUpdated, this, &StatusView::update);
-        disconnect(m_monitor.data(), &Monitor::nodeRemoved, this, &StatusView::removeNode);
-        disconnect(m_monitor.data(), &Monitor::nodeUpdated, this, &StatusView::checkNode);
+        disconnectMonitor();
         disconnect(m_monitor.data(), &Monitor::schedulerStateChanged,
                    this, &StatusView::updateSchedulerState);
     }
@@ -65,20 +64,54 @@ void StatusView::setMonitor(Monitor *monitor)
     m_monitor = monitor;
 
     if (m_monitor) {
-        connect(m_monitor.data(), &Monitor::jobUpdated, this, &StatusView::update);
-        connect(m_monitor.data(), &Monitor::nodeRemoved, this, &StatusView::removeNode);
-        connect(m_monitor.data(), &Monitor::nodeUpdated, this, &StatusView::checkNode);
+        if (m_paused) {
+            m_pausedSequence = m_monitor->jobStore()->sequence();
+        } else {
+            connectMonitor();
+        }
         connect(m_monitor.data(), &Monitor::schedulerStateChanged,
                 this, &StatusView::updateSchedulerState);
 
         if (options().testFlag(RememberJobsOption)) {
-            foreach(const Job &job, m_monitor->jobHistory()) {
-                update(job);
-            }
+            loadSnapshot(m_monitor->jobStore()->snapshot());
         }
     }
 }
 
+void StatusView::connectMonitor()
+{
+    connect(m_monitor.data(), &Monitor::jobUpdated, this, &StatusView::update);
+    connect(m_monitor.data(), &Monitor::nodeRemoved, this, &StatusView::removeNode);
+    connect(m_monitor.data(), &Monitor::nodeUpdated, this, &StatusView::checkNode);
+}
+
+void StatusView::disconnectMonitor()
+{
+    disconnect(m_monitor.data(), &Monitor::jobUpdated, this, &StatusView::update);
+    disconnect(m_monitor.data(), &Monitor::nodeRemoved, this, &StatusView::removeNode);
+    disconnect(m_monitor.data(), &Monitor::nodeUpdated, this, &StatusView::checkNode);
+}
+
+void StatusView::loadSnapshot(const QVector<Job> &jobs)
+{
+    for (const Job &job : jobs) {
+        update(job);
+    }
+}
+
+void StatusView::applyDelta(const JobStore::Delta &delta)
+{
+    for (HostId host : delta.updatedHosts) {
+        checkNode(host);
+    }
+    for (const Job &job : delta.jobs) {
+        update(job);
+    }
+    for (HostId host : delta.removedHosts) {
+        removeNode(host);
+    }
+}
+
 HostInfoManager *StatusView::hostInfoManager() const
 {
     return (m_monitor ? m_monitor->hostInfoManager() : nullptr);
@@ -137,11 +170,31 @@ unsigned int StatusView::processor(const Job &job)
 
 void StatusView::togglePause()
 {
-    if (m_paused) {
-        start();
-    } else {
-        stop();
+    setPaused(!m_paused);
+}
+
+void StatusView::setPaused(bool paused)
+{
+    if (m_paused == paused) {
+        return;
     }
 
-    m_paused = !m_paused;
+    m_paused = paused;
+
+    if (paused) {
+        stop();
+        if (m_monitor) {
+            disconnectMonitor();
+            m_pausedSequence = m_monitor->jobStore()->sequence();
+        }
+    } else {
+        if (m_monitor) {
+            connectMonitor();
+        }
+        start();
+        // The final state of whatever changed, not every event in between
+        if (m_monitor) {
+            applyDelta(m_monitor->jobStore()->changesSince(m_pausedSequence));
+        }
+    }
 }
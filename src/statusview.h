@@ -23,11 +23,13 @@
 #ifndef ICEMON_STATUSVIEW_H
 #define ICEMON_STATUSVIEW_H
 
+#include "jobstore.h"
 #include "monitor.h"
 #include "types.h"
 
 #include <QObject>
 #include <QPointer>
+#include <QVector>
 
 class HostInfoManager;
 class Job;
@@ -71,6 +73,13 @@ public:
     virtual void start() {}
     void togglePause();
 
+    bool isPaused() const { return m_paused; }
+    /**
+     * A paused view is disconnected from the monitor. When resumed it
+     * catches up with the changes of the job store made in the meantime.
+     */
+    void setPaused(bool paused);
+
     virtual QString id() const = 0;
 
     unsigned int processor(const Job &);
@@ -78,6 +87,21 @@ public:
     QString nameForHost(unsigned int hostid);
     QColor hostColor(unsigned int hostid);
 
+protected:
+    /**
+     * Called with the current state of all retained jobs when a view with
+     * RememberJobsOption gets a monitor. The default replays them through
+     * update(), views with a model should load them in one go instead.
+     */
+    virtual void loadSnapshot(const QVector<Job> &jobs);
+
+    /**
+     * Called when resuming with the final state of the jobs and hosts which
+     * changed while the view was paused. The default passes them to
+     * checkNode(), update() and removeNode().
+     */
+    virtual void applyDelta(const JobStore::Delta &delta);
+
 protected Q_SLOTS:
     virtual void update(const Job &job);
     virtual void checkNode(HostId hostid);
@@ -85,8 +109,12 @@ protected Q_SLOTS:
     virtual void updateSchedulerState(Monitor::SchedulerState state);
 
 private:
+    void connectMonitor();
+    void disconnectMonitor();
+
     QPointer<Monitor> m_monitor;
     bool m_paused{false};
+    quint64 m_pausedSequence{0};
 };
 
 #endif
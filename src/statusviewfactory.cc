@@ -26,6 +26,9 @@
 #include "views/ganttstatusview.h"
 #include "views/listview.h"
 #include "views/flowtableview.h"
+#include "views/heatmapview.h"
+#include "views/sessionview.h"
+#include "views/timelineview.h"
 
 StatusView *StatusViewFactory::create(const QString &id, QObject *parent)
 {
@@ -39,6 +42,12 @@ StatusView *StatusViewFactory::create(const QString &id, QObject *parent)
         return new FlowTableView(parent);
     } else if (id == QLatin1String("detailedhost")) {
         return new DetailedHostView(parent);
+    } else if (id == QLatin1String("heatmap")) {
+        return new HeatmapView(parent);
+    } else if (id == QLatin1String("timeline")) {
+        return new TimelineView(parent);
+    } else if (id == QLatin1String("sessions")) {
+        return new SessionView(parent);
     }
 
     return new StarView(parent);
@@ -78,7 +78,6 @@ DetailedHostView::DetailedHostView(QObject *parent)
     dummy->setContentsMargins({});
 
     mLocalJobsModel = new JobListModel(this);
-    mLocalJobsModel->setExpireDuration(5);
     mLocalJobsModel->setJobType(JobListModel::LocalJobs);
     mSortedLocalJobsModel = new JobListSortFilterProxyModel(this);
     mSortedLocalJobsModel->setDynamicSortFilter(true);
@@ -96,7 +95,6 @@ DetailedHostView::DetailedHostView(QObject *parent)
     dummy->setContentsMargins({});
 
     mRemoteJobsModel = new JobListModel(this);
-    mRemoteJobsModel->setExpireDuration(5);
     mRemoteJobsModel->setJobType(JobListModel::RemoteJobs);
     mSortedRemoteJobsModel = new JobListSortFilterProxyModel(this);
     mSortedRemoteJobsModel->setDynamicSortFilter(true);
@@ -136,6 +134,34 @@ void DetailedHostView::checkNode(unsigned int hostid)
     }
 }
 
+void DetailedHostView::stop()
+{
+    mHostListModel->setUpdatesEnabled(false);
+    mLocalJobsModel->setUpdatesEnabled(false);
+    mRemoteJobsModel->setUpdatesEnabled(false);
+}
+
+void DetailedHostView::start()
+{
+    mHostListModel->setUpdatesEnabled(true);
+    mLocalJobsModel->setUpdatesEnabled(true);
+    mRemoteJobsModel->setUpdatesEnabled(true);
+}
+
+void DetailedHostView::applyDelta(const JobStore::Delta &delta)
+{
+    for (HostId host : delta.updatedHosts) {
+        mHostListModel->checkNode(host);
+    }
+    for (HostId host : delta.removedHosts) {
+        mHostListModel->removeNodeById(host);
+    }
+    mLocalJobsModel->updateJobs(delta.jobs);
+    mRemoteJobsModel->updateJobs(delta.jobs);
+
+    StatusView::applyDelta(delta);
+}
+
 void DetailedHostView::createKnownHosts()
 {
     if (!hostInfoManager()) {
@@ -49,6 +49,12 @@ public:
 
     void checkNode(unsigned int hostid) override;
 
+    void stop() override;
+    void start() override;
+
+protected:
+    void applyDelta(const JobStore::Delta &delta) override;
+
 private slots:
     void slotNodeActivated();
 
@@ -20,119 +20,457 @@
 
 #include "flowtableview.h"
 
+#include "framescheduler.h"
+
 #include <QHeaderView>
 #include <QIcon>
 #include <QDebug>
 #include <QPainter>
 #include <QTimer>
 
-ProgressWidget::ProgressWidget(HostInfo *info, StatusView *statusView, QWidget *parent)
-    : QWidget(parent)
-    , m_hostInfo(info)
-    , m_statusView(statusView)
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// One column of history each
+const int HistoryColumnMsecs = 50;
+// Longer gaps mean nothing was rendered, e.g. while hidden, and are skipped
+const int MaxCatchUpColumns = 10;
+
+}
+
+FlowHistoryRing::FlowHistoryRing(int columns)
+    : m_columns(qMax(1, columns))
+    , m_bands(1)
+    , m_image(m_columns, m_bands * BandHeight, QImage::Format_RGB32)
+    , m_baseColor(qRgb(255, 255, 255))
+{
+    m_image.fill(m_baseColor);
+    Q_ASSERT(!m_image.isNull());
+}
+
+void FlowHistoryRing::setBaseColor(const QColor &color)
+{
+    m_baseColor = color.rgb();
+    m_image.fill(m_baseColor);
+}
+
+int FlowHistoryRing::addBand()
+{
+    if (!m_freeBands.isEmpty()) {
+        const int band = m_freeBands.takeLast();
+        m_bandColors[band] = m_baseColor;
+        return band;
+    }
+
+    const int band = m_bandColors.size();
+    m_bandColors.append(m_baseColor);
+    if (m_bandColors.size() > m_bands) {
+        resize(m_columns, qMax(16, m_bandColors.size() * 2));
+    }
+    return band;
+}
+
+void FlowHistoryRing::removeBand(int band)
+{
+    // Clear the history, the band will be handed out again
+    for (int y = band * BandHeight; y < (band + 1) * BandHeight; ++y) {
+        auto *line = reinterpret_cast<QRgb *>(m_image.scanLine(y));
+        std::fill(line, line + m_image.width(), m_baseColor);
+    }
+    m_bandColors[band] = m_baseColor;
+    m_freeBands.append(band);
+}
+
+void FlowHistoryRing::setBandColor(int band, const QColor &color)
+{
+    m_bandColors[band] = color.isValid() ? color.rgb() : m_baseColor;
+}
+
+void FlowHistoryRing::ensureColumns(int columns)
+{
+    if (columns > m_columns) {
+        resize(columns, m_bands);
+    }
+}
+
+void FlowHistoryRing::resize(int columns, int bands)
+{
+    // Both at least one, a null image would never be painted
+    columns = qMax(qMax(1, columns), m_columns);
+    bands = qMax(qMax(1, bands), m_bands);
+
+    QImage image(columns, bands * BandHeight, QImage::Format_RGB32);
+    image.fill(m_baseColor);
+    Q_ASSERT(!image.isNull());
+
+    // Unroll the ring so the newest column ends up at the right border
+    const int width = m_columns;
+    const int height = m_bands * BandHeight;
+    for (int y = 0; y < height; ++y) {
+        const auto *src = reinterpret_cast<const QRgb *>(m_image.constScanLine(y));
+        auto *dst = reinterpret_cast<QRgb *>(image.scanLine(y)) + (columns - width);
+        std::copy(src + m_head + 1, src + width, dst);
+        std::copy(src, src + m_head + 1, dst + width - m_head - 1);
+    }
+
+    m_image = image;
+    m_columns = columns;
+    m_bands = bands;
+    m_head = columns - 1;
+}
+
+const QVector<QRgb> &FlowHistoryRing::gradient(QRgb color)
+{
+    QHash<QRgb, QVector<QRgb>>::ConstIterator it = m_gradients.constFind(color);
+    if (it != m_gradients.constEnd()) {
+        return *it;
+    }
+
+    // Vertical gradient from the base color at the top to the job color at the bottom
+    QVector<QRgb> column(BandHeight);
+    for (int y = 0; y < BandHeight; ++y) {
+        const int f = (2 * y + 1) * 256 / (2 * BandHeight);
+        column[y] = qRgb((qRed(m_baseColor) * (256 - f) + qRed(color) * f) / 256,
+                         (qGreen(m_baseColor) * (256 - f) + qGreen(color) * f) / 256,
+                         (qBlue(m_baseColor) * (256 - f) + qBlue(color) * f) / 256);
+    }
+    return *m_gradients.insert(color, column);
+}
+
+void FlowHistoryRing::advance()
+{
+    m_head = (m_head + 1) % m_columns;
+
+    uchar *bits = m_image.bits();
+    const qsizetype bytesPerLine = m_image.bytesPerLine();
+    for (int band = 0; band < m_bandColors.size(); ++band) {
+        const QRgb color = m_bandColors.at(band);
+        const int top = band * BandHeight;
+        if (color == m_baseColor) {
+            for (int y = 0; y < BandHeight; ++y) {
+                reinterpret_cast<QRgb *>(bits + (top + y) * bytesPerLine)[m_head] = m_baseColor;
+            }
+        } else {
+            const QVector<QRgb> &column = gradient(color);
+            for (int y = 0; y < BandHeight; ++y) {
+                reinterpret_cast<QRgb *>(bits + (top + y) * bytesPerLine)[m_head] = column.at(y);
+            }
+        }
+    }
+}
+
+void FlowHistoryRing::draw(QPainter *painter, const QRect &target, int band) const
+{
+    if (band < 0 || band >= m_bands) {
+        return;
+    }
+
+    const int width = m_columns;
+    const int count = qMin(target.width(), width);
+    const int top = band * BandHeight;
+    const int right = target.x() + target.width();
+
+    if (count < target.width()) {
+        painter->fillRect(target.x(), target.y(), target.width() - count, target.height(), QColor(m_baseColor));
+    }
+
+    // Newest part: columns [0, head] of the ring, at the right border
+    const int newest = qMin(count, m_head + 1);
+    painter->drawImage(QRect(right - newest, target.y(), newest, target.height()), m_image,
+                       QRect(m_head + 1 - newest, top, newest, BandHeight));
+
+    // Oldest part: wrapped around to the end of the ring
+    const int oldest = count - newest;
+    if (oldest > 0) {
+        painter->drawImage(QRect(right - count, target.y(), oldest, target.height()), m_image,
+                           QRect(width - oldest, top, oldest, BandHeight));
+    }
+}
+
+FlowTableModel::FlowTableModel(FlowHistoryRing *history, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_history(history)
+{
+}
+
+QVariant FlowTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ColumnHost:
+            return tr("Host");
+        case ColumnFile:
+            return tr("File");
+        case ColumnHistory:
+            return tr("History");
+        case ColumnState:
+            return tr("State");
+        default:
+            break;
+        }
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant FlowTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows.at(index.row());
+    if (role == HostIdRole) {
+        return row.hostId;
+    } else if (role == HistoryBandRole) {
+        return row.band;
+    }
+
+    switch (index.column()) {
+    case ColumnHost:
+        if (role == Qt::DisplayRole) {
+            return row.hostText;
+        } else if (role == Qt::ToolTipRole) {
+            return row.toolTip;
+        } else if (role == Qt::BackgroundRole) {
+            return row.color;
+        } else if (role == Qt::DecorationRole) {
+            static const QIcon icon(QStringLiteral(":/images/icemonnode.png"));
+            return icon;
+        }
+        break;
+    case ColumnFile:
+        if (role == Qt::DisplayRole) {
+            return row.fileName;
+        } else if (role == Qt::ToolTipRole) {
+            return row.filePath;
+        }
+        break;
+    case ColumnState:
+        if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+            return row.state;
+        }
+        break;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+int FlowTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _ColumnCount;
+}
+
+int FlowTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int FlowTableModel::band(HostId hostId) const
 {
-    setAutoFillBackground(false);
-    setAttribute(Qt::WA_OpaquePaintEvent);
-    setAttribute(Qt::WA_NoSystemBackground);
-    m_backingStore = QImage(size(), QImage::Format_RGB32);
-    m_backingStore.fill(palette().base().color().rgb());
+    const int row = m_rowForHost.value(hostId, -1);
+    return row < 0 ? -1 : m_rows.at(row).band;
 }
 
-void ProgressWidget::paintEvent(QPaintEvent *)
+QString FlowTableModel::hostText(HostInfo *hostInfo)
 {
-    QImage temp(size(), QImage::Format_RGB32);
-    QPainter p(&temp);
+    if ((hostInfo->serverSpeed() == 0) && (hostInfo->numJobs() == 0)) { // host disabled
+        return tr("%1 (not accepting jobs)").arg(hostInfo->name());
+    } else {
+        return tr("%1 (%2/%3)").arg(hostInfo->name()).arg(hostInfo->numJobs()).arg(hostInfo->maxJobs());
+    }
+}
+
+void FlowTableModel::clear()
+{
+    beginResetModel();
+    for (const Row &row : std::as_const(m_rows)) {
+        m_history->removeBand(row.band);
+    }
+    m_rows.clear();
+    m_rowForHost.clear();
+    endResetModel();
+}
 
-    p.drawImage(-1, 0, m_backingStore);
+void FlowTableModel::addHosts(const QVector<HostInfo *> &hosts)
+{
+    if (hosts.isEmpty()) {
+        return;
+    }
+
+    const int first = m_rows.size();
+    beginInsertRows(QModelIndex(), first, first + hosts.size() - 1);
+    m_rows.reserve(first + hosts.size());
+    for (HostInfo *hostInfo : hosts) {
+        m_rowForHost.insert(hostInfo->id(), m_rows.size());
+        m_rows.append({hostInfo->id(), hostText(hostInfo), hostInfo->toolTip(), hostInfo->color(),
+                       QString(), QString(), QString(), m_history->addBand()});
+    }
+    endInsertRows();
+}
 
-    if (m_isVirgin) {
-        p.fillRect(rect(), palette().base());
-        m_isVirgin = false;
+void FlowTableModel::removeHost(HostId hostId)
+{
+    const int row = m_rowForHost.value(hostId, -1);
+    if (row < 0) {
+        return;
     }
 
-    if (m_currentJob.state == Job::Compiling ||
-        m_currentJob.state == Job::LocalOnly) {
-        QLinearGradient gradient;
-        gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
-        gradient.setColorAt(0, palette().base().color());
-        gradient.setColorAt(1, m_statusView->hostColor(m_currentJob.client));
-        p.fillRect(width() - 1, 0, 1, height(), gradient);
+    m_history->removeBand(m_rows.at(row).band);
+    m_rowForHost.remove(hostId);
+
+    // Move the last row into the gap instead of shifting all following rows
+    const int last = m_rows.size() - 1;
+    if (row != last) {
+        m_rows[row] = m_rows.at(last);
+        m_rowForHost.insert(m_rows.at(row).hostId, row);
+        emit dataChanged(index(row, 0), index(row, _ColumnCount - 1));
+    }
+
+    beginRemoveRows(QModelIndex(), last, last);
+    m_rows.removeLast();
+    endRemoveRows();
+}
+
+void FlowTableModel::updateHost(HostInfo *hostInfo)
+{
+    const int row = m_rowForHost.value(hostInfo->id(), -1);
+    if (row < 0) {
+        return;
+    }
+
+    QString text = hostText(hostInfo);
+    if (m_rows.at(row).hostText != text) {
+        m_rows[row].hostText = std::move(text);
+        const QModelIndex idx = index(row, ColumnHost);
+        emit dataChanged(idx, idx, {Qt::DisplayRole});
+    }
+}
+
+void FlowTableModel::updateJob(const Job &job)
+{
+    const int rowIndex = m_rowForHost.value(job.server, -1);
+    if (rowIndex < 0) {
+        return;
+    }
+
+    Row &row = m_rows[rowIndex];
+    if (job.state == Job::Finished) {
+        row.fileName.clear();
+        row.filePath.clear();
+        row.state.clear();
     } else {
-        p.fillRect(width() - 1, 0, 1, height(), palette().base().color());
+        row.fileName = job.fileName.mid(job.fileName.lastIndexOf(QLatin1Char('/')) + 1);
+        row.filePath = job.fileName;
+        row.state = job.stateAsString();
     }
+    emit dataChanged(index(rowIndex, ColumnFile), index(rowIndex, ColumnState));
+}
 
-    QPainter screenp(this);
-    screenp.drawImage(0, 0, temp);
-    m_backingStore = temp;
+FlowHistoryDelegate::FlowHistoryDelegate(FlowHistoryRing *history, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_history(history)
+{
 }
 
-void ProgressWidget::resizeEvent(QResizeEvent *) {
-    m_isVirgin = true;
+void FlowHistoryDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    m_history->draw(painter, option.rect, index.data(FlowTableModel::HistoryBandRole).toInt());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 FlowTableView::FlowTableView(QObject *parent)
     : StatusView(parent)
-    , m_widget(new QTableWidget)
-    , m_updateTimer(new QTimer)
-{
-    m_widget->setColumnCount(4);
-    QStringList labels;
-    labels << tr("Host") << tr("File") << tr("History") << tr("State");
-    m_widget->setHorizontalHeaderLabels(labels);
-    m_widget->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
-    m_widget->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    , m_model(new FlowTableModel(&m_history, this))
+    , m_widget(new QTableView)
+{
+    m_history.setBaseColor(m_widget->palette().base().color());
+
+    m_widget->setModel(m_model);
+    m_widget->setItemDelegateForColumn(FlowTableModel::ColumnHistory, new FlowHistoryDelegate(&m_history, this));
+    m_widget->horizontalHeader()->setSectionResizeMode(FlowTableModel::ColumnHistory, QHeaderView::Stretch);
     m_widget->verticalHeader()->hide();
+    m_widget->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     m_widget->setSelectionMode(QAbstractItemView::NoSelection);
+    m_widget->setWordWrap(false);
+    connect(m_widget->horizontalHeader(), &QHeaderView::sectionResized,
+            this, &FlowTableView::historySectionResized);
+
+    m_historyClock.start();
+    FrameScheduler::instance()->addCallback(this, [this]() { advanceHistory(); }, HistoryColumnMsecs);
 
-    m_updateTimer->setInterval(50);
-    m_updateTimer->start();
+    m_pendingHostsTimer.setSingleShot(true);
+    m_pendingHostsTimer.setInterval(100);
+    connect(&m_pendingHostsTimer, &QTimer::timeout, this, &FlowTableView::addPendingHosts);
 
     createKnownHosts();
 }
 
 void FlowTableView::update(const Job &job)
 {
-    int serverId = job.server;
+    const HostId serverId = job.server;
     if (serverId == 0) {
         return;
     }
 
+    // Don't lose jobs of hosts which are still waiting to be added
+    if (!m_model->contains(serverId) && m_pendingHosts.contains(serverId)) {
+        addPendingHosts();
+    }
+
     // checkNode hasn't been run for this server yet.
-    if (!m_idToRowMap.contains(serverId)) {
+    const int band = m_model->band(serverId);
+    if (band < 0) {
         return;
     }
 
-    int serverRow = m_idToRowMap.value(serverId);
-    QTableWidgetItem *fileNameItem = m_widget->item(serverRow, 1);
-    QTableWidgetItem *jobStateItem = m_widget->item(serverRow, 3);
+    m_model->updateJob(job);
 
-    if (job.state == Job::Finished) {
-        fileNameItem->setText(QLatin1String(""));
-        jobStateItem->setText(QLatin1String(""));
-    } else {
-        QString filePath = job.fileName;
-        QString fileName = filePath.mid(filePath.lastIndexOf(QLatin1Char('/')) + 1);
-        fileNameItem->setText(fileName);
-        fileNameItem->setToolTip(job.fileName);
-        fileNameItem->setFlags(Qt::ItemIsEnabled);
-        jobStateItem->setText(job.stateAsString());
-        jobStateItem->setToolTip(job.stateAsString());
-        jobStateItem->setFlags(Qt::ItemIsEnabled);
+    const bool active = (job.state == Job::Compiling || job.state == Job::LocalOnly);
+    m_history.setBandColor(band, active ? hostColor(job.client) : QColor());
+
+    // update the host column for the server requesting the job
+    if (HostInfo *hostInfo = hostInfoManager()->find(serverId)) {
+        m_model->updateHost(hostInfo);
     }
+}
 
-    if (auto * progressWidget = static_cast<ProgressWidget *>(m_widget->cellWidget(serverRow, 2))) {
-        progressWidget->setCurrentJob(job);
+void FlowTableView::advanceHistory()
+{
+    // The callback runs on the frames, which needn't be a multiple of the
+    // column time apart, so add as many columns as are due
+    const qint64 now = m_historyClock.elapsed();
+    const qint64 columns = (now - m_historyTime) / HistoryColumnMsecs;
+    if (columns <= 0) {
+        return;
+    }
+    if (columns > MaxCatchUpColumns) {
+        m_history.advance();
+        m_historyTime = now;
+    } else {
+        for (qint64 i = 0; i < columns; ++i) {
+            m_history.advance();
+        }
+        m_historyTime += columns * HistoryColumnMsecs;
     }
 
-    // update the host column for the server requesting the job
-    QTableWidgetItem *hostNameItem = m_widget->item(serverRow, 0);
-    HostInfo *hostInfo = hostInfoManager()->find(serverId);
+    // Repaints the history of all visible rows
+    QWidget *viewport = m_widget->viewport();
+    FrameScheduler::instance()->markDirty(viewport, QRect(m_widget->columnViewportPosition(FlowTableModel::ColumnHistory), 0,
+                                                          m_widget->columnWidth(FlowTableModel::ColumnHistory), viewport->height()));
+}
 
-    QFont f = m_widget->font();
-    hostNameItem->setFont(f);
-    hostNameItem->setText(hostInfoText(hostInfo));
+void FlowTableView::historySectionResized(int logicalIndex, int oldSize, int newSize)
+{
+    Q_UNUSED(oldSize);
+
+    if (logicalIndex == FlowTableModel::ColumnHistory) {
+        m_history.ensureColumns(newSize);
+    }
 }
 
 QWidget *FlowTableView::widget() const
@@ -140,27 +478,51 @@ QWidget *FlowTableView::widget() const
     return m_widget.data();
 }
 
-QString FlowTableView::hostInfoText(HostInfo *hostInfo) {
-    if ((hostInfo->serverSpeed() == 0) && (hostInfo->numJobs() == 0)) { // host disabled
-        return tr("%1 (not accepting jobs)").arg(hostInfo->name());
-    } else {
-        return tr("%1 (%2/%3)").arg(hostInfo->name()).arg(hostInfo->numJobs()).arg(hostInfo->maxJobs());
-    }
-}
-
 void FlowTableView::createKnownHosts()
 {
+    m_pendingHosts.clear();
+    m_pendingHostsTimer.stop();
+    m_model->clear();
+    m_hostColumnWidth = 0;
+
     if (!hostInfoManager()) {
         return;
     }
 
-    m_widget->setRowCount(0);
-    m_idToRowMap.clear();
-
     const HostInfoManager::HostMap hosts(hostInfoManager()->hostMap());
+    for (auto it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
+        m_pendingHosts.insert(it.key());
+    }
+    addPendingHosts();
+}
 
-    foreach(int hostid, hosts.keys()) {
-        checkNode(hostid);
+void FlowTableView::addPendingHosts()
+{
+    m_pendingHostsTimer.stop();
+
+    QVector<HostId> hostIds(m_pendingHosts.constBegin(), m_pendingHosts.constEnd());
+    std::sort(hostIds.begin(), hostIds.end());
+
+    QVector<HostInfo *> hosts;
+    hosts.reserve(hostIds.size());
+    for (HostId hostId : std::as_const(hostIds)) {
+        HostInfo *hostInfo = hostInfoManager()->find(hostId);
+        if (hostInfo && !m_model->contains(hostId)) {
+            hosts.append(hostInfo);
+        }
+    }
+    m_pendingHosts.clear();
+    m_model->addHosts(hosts);
+
+    // Only the new names are measured, the column keeps the widest so far
+    const QFontMetrics metrics(m_widget->font());
+    int width = m_hostColumnWidth;
+    for (HostInfo *hostInfo : std::as_const(hosts)) {
+        width = qMax(width, metrics.horizontalAdvance(FlowTableModel::hostText(hostInfo)) + 32);
+    }
+    if (width != m_hostColumnWidth) {
+        m_hostColumnWidth = width;
+        m_widget->horizontalHeader()->resizeSection(FlowTableModel::ColumnHost, width);
     }
 }
 
@@ -174,40 +536,18 @@ void FlowTableView::setMonitor(Monitor *monitor)
 
 void FlowTableView::checkNode(unsigned int hostId)
 {
-    if (m_idToRowMap.contains(hostId)) {
+    if (m_model->contains(hostId) || m_pendingHosts.contains(hostId)) {
         return;
     }
 
-    HostInfo *hostInfo = hostInfoManager()->hostMap().value(hostId);
-    auto *widgetItem = new QTableWidgetItem(hostInfoText(hostInfo));
-    widgetItem->setIcon(QIcon(QStringLiteral(":/images/icemonnode.png")));
-    widgetItem->setToolTip(hostInfo->toolTip());
-    widgetItem->setBackground(hostInfo->color());
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    int insertRow = m_widget->rowCount();
-    m_widget->setRowCount(insertRow + 1);
-    m_idToRowMap.insert(hostId, insertRow);
-    m_widget->setItem(insertRow, 0, widgetItem);
-    // adjust column width
-    int width = QFontMetrics(widgetItem->font()).horizontalAdvance(widgetItem->text()) + 32;
-    m_widget->horizontalHeader()->resizeSection(0, qMax(m_widget->horizontalHeader()->sectionSize(0), width));
-
-    widgetItem = new QTableWidgetItem;
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    m_widget->setItem(insertRow, 1, widgetItem);
-
-    widgetItem = new QTableWidgetItem;
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    m_widget->setItem(insertRow, 3, widgetItem);
-
-    auto pw = new ProgressWidget(hostInfo, this);
-    connect(m_updateTimer, SIGNAL(timeout()), pw, SLOT(update()));
-    m_widget->setCellWidget(insertRow, 2, pw);
+    m_pendingHosts.insert(hostId);
+    if (!m_pendingHostsTimer.isActive()) {
+        m_pendingHostsTimer.start();
+    }
 }
 
 void FlowTableView::removeNode(unsigned int hostId)
 {
-    Q_UNUSED(hostId);
-
-    createKnownHosts();
+    m_pendingHosts.remove(hostId);
+    m_model->removeHost(hostId);
 }
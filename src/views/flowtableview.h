@@ -25,32 +25,137 @@
 #include "hostinfo.h"
 #include "statusview.h"
 
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
 #include <QScopedPointer>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QSet>
+#include <QStyledItemDelegate>
+#include <QTableView>
+#include <QTimer>
 
 class Job;
 
-using HostIdRowMap = QHash<int, int>;
+/**
+ * The history of all flow rows, kept in one circular image
+ *
+ * Each host owns a band of BandHeight pixel rows. Every tick writes one
+ * column for all bands at a moving offset, so nothing is ever shifted; a
+ * row is drawn by blitting the two halves on either side of the offset.
+ */
+class FlowHistoryRing
+{
+public:
+    static const int BandHeight = 16;
+
+    explicit FlowHistoryRing(int columns = 512);
+
+    void setBaseColor(const QColor &color);
+
+    int addBand();
+    void removeBand(int band);
+
+    /// Color to draw for @p band from the next tick on, invalid when idle
+    void setBandColor(int band, const QColor &color);
+
+    /// Makes sure at least @p columns ticks of history are kept
+    void ensureColumns(int columns);
+
+    /// Writes the next column of every band
+    void advance();
+
+    /// Draws the newest history of @p band, the most recent tick at the right of @p target
+    void draw(QPainter *painter, const QRect &target, int band) const;
+
+private:
+    const QVector<QRgb> &gradient(QRgb color);
+    void resize(int columns, int bands);
+
+    /// Size of the ring, never less than one column and one band
+    int m_columns;
+    int m_bands;
+    QImage m_image;
+    int m_head{0};
+    QVector<QRgb> m_bandColors;
+    QVector<int> m_freeBands;
+    QRgb m_baseColor;
+    QHash<QRgb, QVector<QRgb>> m_gradients;
+};
+
+/**
+ * One row per host, rows are kept in insertion order except that removing a
+ * host moves the last row into its place
+ */
+class FlowTableModel
+    : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnHost,
+        ColumnFile,
+        ColumnHistory,
+        ColumnState,
+        _ColumnCount
+    };
+
+    enum Role
+    {
+        HostIdRole = Qt::UserRole,
+        HistoryBandRole
+    };
+
+    explicit FlowTableModel(FlowHistoryRing *history, QObject *parent = nullptr);
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    bool contains(HostId hostId) const { return m_rowForHost.contains(hostId); }
+    int band(HostId hostId) const;
+
+    void clear();
+    void addHosts(const QVector<HostInfo *> &hosts);
+    void removeHost(HostId hostId);
+    void updateHost(HostInfo *hostInfo);
+    void updateJob(const Job &job);
+
+    static QString hostText(HostInfo *hostInfo);
+
+private:
+    struct Row
+    {
+        HostId hostId;
+        QString hostText;
+        QString toolTip;
+        QColor color;
+        QString fileName;
+        QString filePath;
+        QString state;
+        int band;
+    };
+
+    FlowHistoryRing *m_history;
+    QVector<Row> m_rows;
+    QHash<HostId, int> m_rowForHost;
+};
 
-class ProgressWidget
-    : public QWidget
+class FlowHistoryDelegate
+    : public QStyledItemDelegate
 {
     Q_OBJECT
+
 public:
-    ProgressWidget(HostInfo *info, StatusView *statusView, QWidget *parent = nullptr);
+    explicit FlowHistoryDelegate(FlowHistoryRing *history, QObject *parent = nullptr);
 
-    void setCurrentJob(const Job &job) { m_currentJob = job; }
-    Job currentJob() const { return m_currentJob; }
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
-    void resizeEvent(QResizeEvent *) override;
-    void paintEvent(QPaintEvent *) override;
 private:
-    HostInfo *m_hostInfo;
-    StatusView *m_statusView;
-    Job m_currentJob;
-    QImage m_backingStore;
-    bool m_isVirgin{true};
+    FlowHistoryRing *m_history;
 };
 
 class FlowTableView
@@ -76,11 +181,23 @@ public:
     bool isPausable() override { return false; }
     bool isConfigurable() override { return false; }
 
+private Q_SLOTS:
+    void advanceHistory();
+    void addPendingHosts();
+    void historySectionResized(int logicalIndex, int oldSize, int newSize);
+
 private:
-    QScopedPointer<QTableWidget> m_widget;
-    QString hostInfoText(HostInfo *hostInfo);
-    HostIdRowMap m_idToRowMap;
-    QTimer *m_updateTimer;
+    FlowHistoryRing m_history;
+    /// Time of the newest history column, the callback doesn't run exactly on the columns
+    QElapsedTimer m_historyClock;
+    qint64 m_historyTime{0};
+    FlowTableModel *m_model;
+    QScopedPointer<QTableView> m_widget;
+
+    // Hosts announced during a login burst, added to the model in one go
+    QSet<HostId> m_pendingHosts;
+    QTimer m_pendingHostsTimer;
+    int m_hostColumnWidth{0};
 
     void createKnownHosts();
 };
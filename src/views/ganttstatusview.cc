@@ -21,6 +21,7 @@
 
 #include "ganttstatusview.h"
 
+#include "framescheduler.h"
 #include "job.h"
 #include "hostinfo.h"
 #include "utils.h"
@@ -30,7 +31,6 @@
 #include <qlayout.h>
 #include <qpainter.h>
 #include <qpixmap.h>
-#include <qtimer.h>
 #include <qcheckbox.h>
 #include <qpushbutton.h>
 #include <QBoxLayout>
@@ -40,8 +40,40 @@
 #include <QResizeEvent>
 #include <QPaintEvent>
 #include <QScrollBar>
+#include <QSettings>
+#include <QSpinBox>
+#include <QTextLayout>
+#include <QWheelEvent>
 #include <QDialogButtonBox>
 
+#include <QtAlgorithms>
+#include <QtMath>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+const int MIN_PIXELS_PER_SECOND = 1;
+const int MAX_PIXELS_PER_SECOND = 200;
+
+// Elided texts are rendered for widths rounded down to a multiple of this,
+// so bars growing by a pixel per tick don't each need a new pixmap
+const int TEXT_WIDTH_GRANULARITY = 8;
+
+// Interned paths are only swept once there are at least this many
+const int MIN_PATHS_BEFORE_SWEEP = 4096;
+
+QString formatAge(int seconds)
+{
+    if (seconds < 60) {
+        return QString::number(seconds);
+    } else if (seconds % 60 == 0) {
+        return QStringLiteral("%1m").arg(seconds / 60);
+    }
+    return QStringLiteral("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QLatin1Char('0'));
+}
+}
+
 GanttConfigDialog::GanttConfigDialog(QWidget *parent)
     : QDialog(parent)
 {
@@ -54,6 +86,25 @@ GanttConfigDialog::GanttConfigDialog(QWidget *parent)
     connect(mTimeScaleVisibleCheck, SIGNAL(clicked()),
             SIGNAL(configChanged()));
 
+    auto *grid = new QGridLayout();
+    topLayout->addLayout(grid);
+
+    grid->addWidget(new QLabel(tr("Zoom:"), this), 0, 0);
+    mPixelsPerSecondSpin = new QSpinBox(this);
+    mPixelsPerSecondSpin->setRange(MIN_PIXELS_PER_SECOND, MAX_PIXELS_PER_SECOND);
+    mPixelsPerSecondSpin->setSuffix(tr(" pixels per second"));
+    grid->addWidget(mPixelsPerSecondSpin, 0, 1);
+    connect(mPixelsPerSecondSpin, SIGNAL(valueChanged(int)),
+            SIGNAL(configChanged()));
+
+    grid->addWidget(new QLabel(tr("Keep history for:"), this), 1, 0);
+    mHistoryHoursSpin = new QSpinBox(this);
+    mHistoryHoursSpin->setRange(1, 24);
+    mHistoryHoursSpin->setSuffix(tr(" hours"));
+    grid->addWidget(mHistoryHoursSpin, 1, 1);
+    connect(mHistoryHoursSpin, SIGNAL(valueChanged(int)),
+            SIGNAL(configChanged()));
+
     auto hline = new QFrame(this);
     hline->setFrameShape(QFrame::HLine);
     topLayout->addWidget(hline);
@@ -77,6 +128,31 @@ bool GanttConfigDialog::isTimeScaleVisible()
     return mTimeScaleVisibleCheck->isChecked();
 }
 
+void GanttConfigDialog::setTimeScaleVisible(bool visible)
+{
+    mTimeScaleVisibleCheck->setChecked(visible);
+}
+
+int GanttConfigDialog::pixelsPerSecond() const
+{
+    return mPixelsPerSecondSpin->value();
+}
+
+void GanttConfigDialog::setPixelsPerSecond(int pixelsPerSecond)
+{
+    mPixelsPerSecondSpin->setValue(pixelsPerSecond);
+}
+
+int GanttConfigDialog::historyHours() const
+{
+    return mHistoryHoursSpin->value();
+}
+
+void GanttConfigDialog::setHistoryHours(int hours)
+{
+    mHistoryHoursSpin->setValue(hours);
+}
+
 GanttTimeScaleWidget::GanttTimeScaleWidget(QWidget *parent)
     : QWidget(parent)
 {
@@ -88,45 +164,218 @@ GanttTimeScaleWidget::GanttTimeScaleWidget(QWidget *parent)
 void GanttTimeScaleWidget::setPixelsPerSecond(int v)
 {
     mPixelsPerSecond = v;
+    QWidget::update();
 }
 
-void GanttTimeScaleWidget::paintEvent(QPaintEvent *pe)
+void GanttTimeScaleWidget::setTimeOffset(qint64 msecs)
 {
-    const QRect r = pe->rect();
+    if (mTimeOffset == msecs) {
+        return;
+    }
+
+    mTimeOffset = msecs;
+    FrameScheduler::instance()->markDirty(this);
+}
+
+void GanttTimeScaleWidget::paintEvent(QPaintEvent *)
+{
+    static const int steps[] = { 1, 5, 10, 30, 60, 300, 600, 1800, 3600 };
+
+    // Pick the tick distances (in seconds) so that neither the small ticks
+    // nor the labelled ones get crowded when zoomed out.
+    int minorStep = steps[0];
+    int majorStep = steps[0];
+    for (int step : steps) {
+        minorStep = step;
+        if (step * mPixelsPerSecond >= 8) {
+            break;
+        }
+    }
+    for (int step : steps) {
+        majorStep = step;
+        if (step >= minorStep * 5 && step * mPixelsPerSecond >= 60) {
+            break;
+        }
+    }
 
     QPainter p(this);
     const QFontMetrics fm = p.fontMetrics();
 
-    // Maybe the rectangle overlaps the right half of a number, check whether
-    // that is the case and repaint that number if necessary.
-    if (r.x() % 100 != 0) {
-        const int lastNumberXPos = r.x() - (r.x() % 100);
-        QString lastNumber = QString::number(lastNumberXPos / 100 * 5);
-        if (r.x() % 100 < p.fontMetrics().horizontalAdvance(lastNumber)) {
-            p.drawText(lastNumberXPos - r.x() + 2, fm.ascent(), lastNumber);
+    const qint64 firstSecond = (mTimeOffset + 999) / 1000;
+    const qint64 lastSecond = mTimeOffset / 1000 + width() / mPixelsPerSecond + 1;
+    for (qint64 second = firstSecond - firstSecond % minorStep; second <= lastSecond; second += minorStep) {
+        const int x = int((second * 1000 - mTimeOffset) * mPixelsPerSecond / 1000);
+        if (x < 0) {
+            continue;
+        }
+
+        if (second % majorStep == 0) {
+            p.drawLine(x, 0, x, height() / 2);
+            p.drawText(x + 2, fm.ascent(), formatAge(int(second)));
+        } else {
+            p.drawLine(x, 0, x, height() / 8);
         }
     }
+}
+
+GanttTextCache::GanttTextCache()
+    : m_layouts(4096)
+    , m_pixmaps(8 * 1024 * 1024)
+{
+}
 
-    // Now draw all the bars and numbers, very straightforward.
-    for (int x = 0; x < r.width(); ++x) {
-        const int absX = x + r.x();
-        if (absX % (mPixelsPerSecond * 10) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 2 - r.y());
-            p.drawText(x + 2, fm.ascent() - r.y(),
-                       QString::number(absX /
-                                       mPixelsPerSecond));
-        } else if (absX % (mPixelsPerSecond * 5) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 4 - r.y());
-            p.drawText(x + 2, fm.ascent() - r.y(),
-                       QString::number(absX /
-                                       mPixelsPerSecond));
-        } else if (absX % (mPixelsPerSecond) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 8 - r.y());
+int GanttTextCache::pathId(const QString &path)
+{
+    if (path.isEmpty()) {
+        return -1;
+    }
+
+    QHash<QString, int>::ConstIterator it = m_pathIds.constFind(path);
+    if (it != m_pathIds.constEnd()) {
+        return *it;
+    }
+
+    const int id = m_nextPathId++;
+    m_fileNames.insert(id, path.mid(path.lastIndexOf(QLatin1Char('/')) + 1));
+    m_pathIds.insert(path, id);
+    return id;
+}
+
+bool GanttTextCache::needsSweep() const
+{
+    // Doubling between sweeps keeps their cost at a constant per path
+    return m_pathIds.size() > qMax(MIN_PATHS_BEFORE_SWEEP, 2 * m_sweptPathCount);
+}
+
+void GanttTextCache::sweep(const QSet<int> &usedIds)
+{
+    for (auto it = m_pathIds.begin(); it != m_pathIds.end();) {
+        if (usedIds.contains(*it)) {
+            ++it;
+            continue;
+        }
+
+        const int id = *it;
+        m_fileNames.remove(id);
+        for (int font = 0; font < m_fonts.size(); ++font) {
+            m_layouts.remove((quint64(font) << 32) | quint32(id));
         }
+        it = m_pathIds.erase(it);
     }
+    m_sweptPathCount = m_pathIds.size();
 }
 
-GanttProgress::GanttProgress(StatusView *statusView, QWidget *parent)
+int GanttTextCache::fontId(const QFont &font)
+{
+    // There is usually just the one font, so a linear search is fine
+    const int index = m_fonts.indexOf(font);
+    if (index != -1) {
+        return index;
+    }
+
+    m_fonts.append(font);
+    return m_fonts.size() - 1;
+}
+
+const GanttTextCache::Layout *GanttTextCache::layout(int pathId, int fontId, const QFont &font)
+{
+    const quint64 key = (quint64(fontId) << 32) | quint32(pathId);
+    if (const Layout *layout = m_layouts.object(key)) {
+        return layout;
+    }
+
+    const QString fileName = m_fileNames.value(pathId);
+
+    // Shaped as a whole, so kerning and ligatures are accounted for, and
+    // only measured at grapheme boundaries so no cluster is ever split
+    auto *layout = new Layout;
+    layout->ellipsisWidth = QFontMetrics(font).horizontalAdvance(QStringLiteral("..."));
+    layout->lengths.append(0);
+    layout->widths.append(0);
+    if (!fileName.isEmpty()) {
+        QTextLayout textLayout(fileName, font);
+        textLayout.beginLayout();
+        QTextLine line = textLayout.createLine();
+        line.setNumColumns(fileName.length());
+        textLayout.endLayout();
+
+        for (int length = 0; length < fileName.length();) {
+            length = textLayout.nextCursorPosition(length);
+            layout->lengths.append(length);
+            layout->widths.append(qMax(layout->widths.last(), qCeil(line.cursorToX(length))));
+        }
+        layout->widths.last() = qMax(layout->widths.last(), qCeil(line.naturalTextWidth()));
+    }
+
+    m_layouts.insert(key, layout);
+    return layout;
+}
+
+QPixmap GanttTextCache::text(int pathId, const QFont &font, int width, int height, const QColor &color)
+{
+    if (pathId < 0 || width <= 0 || height <= 0 || !m_fileNames.contains(pathId)) {
+        return QPixmap();
+    }
+
+    const int fontIndex = fontId(font);
+    const Layout *l = layout(pathId, fontIndex, font);
+    const int fullWidth = l->widths.last();
+
+    // Render for the largest bucket width which fits, or for the full text
+    const int bucketWidth = (width >= fullWidth) ? fullWidth : width - width % TEXT_WIDTH_GRANULARITY;
+    if (bucketWidth <= 0) {
+        return QPixmap();
+    }
+
+    const PixmapKey key{pathId, fontIndex, bucketWidth, height, color.rgb()};
+    if (const QPixmap *pixmap = m_pixmaps.object(key)) {
+        return *pixmap;
+    }
+
+    const QString fileName = m_fileNames.value(pathId);
+    QString s = fileName;
+    int textWidth = fullWidth;
+    if (fullWidth > bucketWidth) {
+        // Longest prefix which still fits together with the ellipsis. The
+        // elided text is measured once more as a whole, the ellipsis may
+        // kern with the end of the prefix.
+        const int available = bucketWidth - l->ellipsisWidth;
+        if (available < 0) {
+            return QPixmap();
+        }
+        const QFontMetrics fm(font);
+        int i = int(std::upper_bound(l->widths.constBegin(), l->widths.constEnd(), available)
+                    - l->widths.constBegin()) - 1;
+        for (; i >= 0; --i) {
+            s = fileName.left(l->lengths.at(i)) + QStringLiteral("...");
+            textWidth = fm.horizontalAdvance(s);
+            if (textWidth <= bucketWidth) {
+                break;
+            }
+        }
+        if (i < 0) {
+            return QPixmap();
+        }
+    }
+
+    if (textWidth <= 0) {
+        return QPixmap();
+    }
+
+    auto *pixmap = new QPixmap(textWidth, height);
+    pixmap->fill(Qt::transparent);
+    QPainter painter(pixmap);
+    painter.setFont(font);
+    painter.setPen(color);
+    painter.drawText(0, 0, textWidth, height, Qt::AlignVCenter | Qt::AlignLeft, s);
+    painter.end();
+
+    const QPixmap result = *pixmap;
+    m_pixmaps.insert(key, pixmap, textWidth * height * 4);
+    return result;
+}
+
+GanttProgress::GanttProgress(GanttStatusView *statusView, QWidget *parent)
     : QWidget(parent)
     , mStatusView(statusView)
 {
@@ -137,53 +386,82 @@ GanttProgress::GanttProgress(StatusView *statusView, QWidget *parent)
 
 void GanttProgress::progress()
 {
-    mClock += 1;
-    adjustGraph();
-    QWidget::update();
+    pruneHistory();
+    FrameScheduler::instance()->markDirty(this);
+}
+
+void GanttProgress::pruneHistory()
+{
+    // Only ever drop finished intervals, the last one is what the slot is doing now
+    const qint64 oldest = mStatusView->clock() - mStatusView->historyLength();
+    int count = 0;
+    while (count < m_jobs.count() - 1 && m_jobs[count].end < oldest) {
+        ++count;
+    }
+
+    if (count > 0) {
+        m_jobs.remove(0, count);
+    }
 }
 
-void GanttProgress::adjustGraph()
+void GanttProgress::collectPathIds(QSet<int> &ids) const
 {
-    // Remove non-visible jobs
-    if (m_jobs.count() >= 2 &&
-        mClock - m_jobs[m_jobs.count() - 2].clock > width()) {
-        m_jobs.removeAt(m_jobs.count() - 1);
+    for (const JobData &data : m_jobs) {
+        if (data.pathId >= 0) {
+            ids.insert(data.pathId);
+        }
     }
 }
 
+void GanttProgress::appendJob(const Job &job, qint64 time)
+{
+    if (!m_jobs.isEmpty()) {
+        m_jobs.last().end = time;
+    }
+    m_jobs.append(JobData(job, time, mStatusView->textCache()->pathId(job.fileName)));
+}
+
 void GanttProgress::update(const Job &job)
 {
-    if (!m_jobs.isEmpty() && m_jobs.first().job == job) {
+    const qint64 now = mStatusView->clock();
+
+    if (!m_jobs.isEmpty() && m_jobs.last().job == job) {
         if (job.state == Job::Finished || job.state == Job::Failed) {
-            Job j = IdleJob();
-            m_jobs.prepend(JobData(j, mClock));
+            appendJob(IdleJob(), now);
             mIsFree = true;
         }
     } else {
-        m_jobs.prepend(JobData(job, mClock));
+        appendJob(job, now);
         mIsFree = (job.state == Job::Idle);
     }
 }
 
 void GanttProgress::drawGraph(QPainter &p)
 {
-    if (height() == 0) {
+    if (height() == 0 || m_jobs.isEmpty()) {
         return;
     }
 
-    bool lastBox = false;
-    int xStart = 0;
-    QList<JobData>::ConstIterator it = m_jobs.constBegin();
-    for (; (it != m_jobs.constEnd()) && !lastBox; ++it) {
-        int xEnd = mClock - (*it).clock;
-
-        if (xEnd > width()) {
-            xEnd = width();
-            lastBox = true;
-        }
+    const qint64 viewTime = mStatusView->viewTime();
+    const int pixelsPerSecond = mStatusView->pixelsPerSecond();
+    const qint64 oldest = viewTime - qint64(width()) * 1000 / pixelsPerSecond;
+    auto xForTime = [viewTime, pixelsPerSecond](qint64 time) {
+        return int((viewTime - time) * pixelsPerSecond / 1000);
+    };
+
+    // The intervals don't overlap, so they are sorted by their end time as
+    // well: skip everything which ended before the visible window.
+    QVector<JobData>::ConstIterator it = std::lower_bound(m_jobs.constBegin(), m_jobs.constEnd(), oldest,
+        [](const JobData &data, qint64 time) {
+            return data.end != -1 && data.end < time;
+        });
+    for (; it != m_jobs.constEnd() && (*it).start <= viewTime; ++it) {
+        const qint64 end = ((*it).end == -1) ? viewTime : qMin((*it).end, viewTime);
+        const int xStart = qMax(0, xForTime(end));
+        const int xEnd = qMin(width(), xForTime((*it).start));
 
         int xWidth = xEnd - xStart;
-        if (xWidth == 0) {
+        if (xWidth <= 0) {
             continue;
         }
 
@@ -194,52 +472,12 @@ void GanttProgress::drawGraph(QPainter &p)
         p.drawRect(xStart, 0, xWidth, height());
 
         if (xWidth > 4 && height() > 4) {
-            int width = xWidth - 4;
-            QString s = (*it).job.fileName;
-            if (!s.isEmpty()) {
-                s = s.mid(s.lastIndexOf(QLatin1Char('/')) + 1, s.length());
-
-                // Optimization - cache the drawn text in a pixmap, and update the cache
-                // only if the pixmap height doesn't match, if the pixmap width is too large,
-                // or if the shortened text with another character added (next_text_width) would fit
-                if (width >= (*it).next_text_width || width < (*it).text_cache.width()
-                    || height() - 4 != (*it).text_cache.height()) {
-                    // If we print the filename, check whether we need to truncate it and
-                    // append "..." at the end.
-                    int text_width = p.fontMetrics().horizontalAdvance(s);
-                    if (text_width > width) {
-                        int threeDotsWidth = p.fontMetrics().horizontalAdvance(QStringLiteral("..."));
-                        int next_width = 0;
-                        int newLength = 0;
-                        for (;
-                             next_width <= width;
-                             ++newLength) {
-                            text_width = next_width;
-                            next_width = p.fontMetrics().horizontalAdvance(s.left(newLength)) +
-                                         threeDotsWidth;
-                        }
-
-                        (*it).next_text_width = next_width;
-                        s  = s.left(newLength > 2 ? newLength - 2 : 0) + QStringLiteral("...");
-                    } else {
-                        (*it).next_text_width = 1000000; // large number (no next width)
-                    }
-                    // Finally draw the text.
-                    if (text_width > 0) {
-                        (*it).text_cache = QPixmap(text_width, height() - 4);
-                        (*it).text_cache.fill(color);
-                        QPainter painter(&(*it).text_cache);
-                        painter.setPen(Utils::textColor(color));
-                        painter.drawText(0, 0, text_width, height() - 4,
-                                         Qt::AlignVCenter | Qt::AlignLeft, s);
-                    }
-                }
-                if (!(*it).text_cache.isNull()) {
-                    p.drawPixmap(xStart + 2, 2, (*it).text_cache);
-                }
+            const QPixmap text = mStatusView->textCache()->text((*it).pathId, font(), xWidth - 4, height() - 4,
+                                                                Utils::textColor(color));
+            if (!text.isNull()) {
+                p.drawPixmap(xStart + 2, 2, text);
             }
         }
-        xStart = xEnd;
     }
 }
 
@@ -265,27 +503,35 @@ void GanttProgress::paintEvent(QPaintEvent *)
     drawGraph(p);
 }
 
-void GanttProgress::resizeEvent(QResizeEvent *)
-{
-    adjustGraph();
-}
-
 GanttStatusView::GanttStatusView(QObject *parent)
     : StatusView(parent)
-    , m_widget(new QScrollArea)
+    , m_widget(new QWidget)
+    , mScrollArea(new QScrollArea)
+    , mHistoryBar(new QScrollBar(Qt::Horizontal))
     , mTopWidget(new QWidget)
 {
-    mConfigDialog = new GanttConfigDialog(m_widget.data());
-    connect(mConfigDialog, SIGNAL(configChanged()),
-            SLOT(slotConfigChanged()));
+    mClock.start();
+
+    auto *mainLayout = new QVBoxLayout(m_widget.data());
+    mainLayout->setContentsMargins({});
+    mainLayout->setSpacing(0);
+    mainLayout->addWidget(mScrollArea);
+    mainLayout->addWidget(mHistoryBar);
+
+    mScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    mScrollArea->setWidget(mTopWidget);
+    mScrollArea->setWidgetResizable(true);
 
-    m_widget->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_widget->setWidget(mTopWidget);
-    m_widget->setWidgetResizable(true);
+    // Scrolling to the right goes back in time, the value is the number of
+    // seconds between now and the left border of the graphs
+    mHistoryBar->setToolTip(tr("Scroll back in time"));
+    connect(mHistoryBar, SIGNAL(valueChanged(int)),
+            SLOT(slotHistoryScrolled(int)));
 
     QPalette palette = mTopWidget->palette();
     palette.setColor(mTopWidget->backgroundRole(), Qt::white);
     mTopWidget->setPalette(palette);
+    mTopWidget->installEventFilter(this);
 
     m_topLayout = new QGridLayout(mTopWidget);
     m_topLayout->setSpacing(5);
@@ -296,21 +542,67 @@ GanttStatusView::GanttStatusView(QObject *parent)
     mTimeScale->setFixedHeight(50);
     m_topLayout->addWidget(mTimeScale, 0, 1);
 
-    m_progressTimer = new QTimer(this);
-    connect(m_progressTimer, SIGNAL(timeout()), SLOT(updateGraphs()));
-    m_ageTimer = new QTimer(this);
-    connect(m_ageTimer, SIGNAL(timeout()), SLOT(checkAge()));
-
     mUpdateInterval = 25;
-    mTimeScale->setPixelsPerSecond(1000 / mUpdateInterval);
+
+    FrameScheduler *scheduler = FrameScheduler::instance();
+    m_progressCallback = scheduler->addCallback(this, [this]() { updateGraphs(); }, mUpdateInterval, false);
+    m_ageCallback = scheduler->addCallback(this, [this]() { checkAge(); }, 10000, false);
 
     mMinimumProgressHeight = QFontMetrics(m_widget->font()).height() + 6;
 
-    slotConfigChanged();
+    mTimeScale->hide();
+
+    readSettings();
 
     start();
 }
 
+GanttStatusView::~GanttStatusView()
+{
+    writeSettings();
+}
+
+void GanttStatusView::readSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    mHistoryHours = qBound(1, settings.value(QStringLiteral("historyHours"), 2).toInt(), 24);
+    setPixelsPerSecond(settings.value(QStringLiteral("pixelsPerSecond"), 40).toInt());
+    settings.endGroup();
+}
+
+void GanttStatusView::writeSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    settings.setValue(QStringLiteral("pixelsPerSecond"), mPixelsPerSecond);
+    settings.setValue(QStringLiteral("historyHours"), mHistoryHours);
+    settings.endGroup();
+    settings.sync();
+}
+
+void GanttStatusView::setPixelsPerSecond(int pixelsPerSecond)
+{
+    pixelsPerSecond = qBound(MIN_PIXELS_PER_SECOND, pixelsPerSecond, MAX_PIXELS_PER_SECOND);
+    if (mPixelsPerSecond == pixelsPerSecond) {
+        return;
+    }
+
+    mPixelsPerSecond = pixelsPerSecond;
+    mTimeScale->setPixelsPerSecond(mPixelsPerSecond);
+    if (mConfigDialog) {
+        const QSignalBlocker blocker(mConfigDialog);
+        mConfigDialog->setPixelsPerSecond(mPixelsPerSecond);
+    }
+
+    // Bars are positioned by time, so repainting more often than once per
+    // pixel of movement is wasted effort
+    mUpdateInterval = qBound(25, 1000 / mPixelsPerSecond, 1000);
+    FrameScheduler::instance()->setCallbackInterval(m_progressCallback, mUpdateInterval);
+
+    updateGraphs();
+}
+
 void GanttStatusView::update(const Job &job)
 {
     if (!mRunning) {
@@ -321,24 +613,24 @@ void GanttStatusView::update(const Job &job)
         return;
     }
 
-    QMap<unsigned int, GanttProgress *>::Iterator it;
-
-    it = mJobMap.find(job.id);
+    const bool finished = (job.state == Job::Finished || job.state == Job::Failed);
 
-    if (it != mJobMap.end()) {
-        it.value()->update(job);
-        if (job.state == Job::Finished || job.state == Job::Failed) {
-            mJobMap.erase(it);
+    JobSlotMap::Iterator it = mJobSlots.find(job.id);
+    if (it != mJobSlots.end()) {
+        GanttProgress *slot = it.value();
+        slot->update(job);
+        if (finished) {
+            mJobSlots.erase(it);
+            slot->clearJobId();
+            updateFreeBit(slot);
         }
         return;
     }
 
-    if (job.state == Job::Finished || job.state == Job::Failed) {
+    if (finished) {
         return;
     }
 
-    GanttProgress *slot = nullptr;
-
     unsigned int processor;
     if (job.state == Job::LocalOnly) {
         processor = job.client;
@@ -350,28 +642,66 @@ void GanttStatusView::update(const Job &job)
         return;
     }
 
-    NodeMap::ConstIterator it2 = mNodeMap.constFind(processor);
-    if (it2 == mNodeMap.constEnd()) {
+    GanttProgress *slot = findFreeSlot(processor);
+    if (!slot) {
         slot = registerNode(processor);
-    } else {
-        SlotList slotList = it2.value();
-        SlotList::ConstIterator it3;
-        for (it3 = slotList.constBegin(); it3 != slotList.constEnd(); ++it3) {
-            if ((*it3)->isFree()) {
-                slot = *it3;
-                break;
-            }
-        }
-
-        if (it3 == slotList.constEnd()) {
-            slot = registerNode(processor);
-        }
     }
 
     Q_ASSERT(slot);
-    mJobMap.insert(job.id, slot);
+    mJobSlots.insert(job.id, slot);
+    slot->setJobId(job.id);
     slot->update(job);
-    mAgeMap[processor] = 0;
+    updateFreeBit(slot);
+    touchNode(processor);
+}
+
+GanttProgress *GanttStatusView::findFreeSlot(unsigned int hostid) const
+{
+    NodeMap::ConstIterator it = mNodes.constFind(hostid);
+    if (it == mNodes.constEnd()) {
+        return nullptr;
+    }
+
+    const NodeSlots &node = it.value();
+    for (int i = 0; i < node.freeBits.size(); ++i) {
+        const quint64 word = node.freeBits.at(i);
+        if (word) {
+            return node.slots.at(i * 64 + qCountTrailingZeroBits(word));
+        }
+    }
+    return nullptr;
+}
+
+void GanttStatusView::setSlotFree(NodeSlots &node, int index, bool free)
+{
+    const quint64 bit = quint64(1) << (index % 64);
+    if (free) {
+        node.freeBits[index / 64] |= bit;
+    } else {
+        node.freeBits[index / 64] &= ~bit;
+    }
+}
+
+void GanttStatusView::updateFreeBit(GanttProgress *slot)
+{
+    NodeMap::Iterator it = mNodes.find(slot->hostId());
+    if (it != mNodes.end()) {
+        setSlotFree(it.value(), slot->slotIndex(), slot->isFree());
+    }
+}
+
+void GanttStatusView::touchNode(unsigned int hostid)
+{
+    NodeMap::Iterator it = mNodes.find(hostid);
+    if (it == mNodes.end() || it->ageBucket == mAgeWheelPos) {
+        return;
+    }
+
+    if (it->ageBucket >= 0) {
+        mAgeWheel[it->ageBucket].remove(hostid);
+    }
+    it->ageBucket = mAgeWheelPos;
+    mAgeWheel[mAgeWheelPos].insert(hostid);
 }
 
 QWidget *GanttStatusView::widget() const
@@ -379,6 +709,24 @@ QWidget *GanttStatusView::widget() const
     return m_widget.data();
 }
 
+bool GanttStatusView::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == mTopWidget && event->type() == QEvent::Wheel) {
+        auto *wheelEvent = static_cast<QWheelEvent *>(event);
+        if (wheelEvent->modifiers() & Qt::ControlModifier) {
+            const int delta = wheelEvent->angleDelta().y();
+            if (delta > 0) {
+                setPixelsPerSecond(qMax(mPixelsPerSecond + 1, mPixelsPerSecond * 5 / 4));
+            } else if (delta < 0) {
+                setPixelsPerSecond(qMin(mPixelsPerSecond - 1, mPixelsPerSecond * 4 / 5));
+            }
+            return true;
+        }
+    }
+
+    return StatusView::eventFilter(watched, event);
+}
+
 void GanttStatusView::removeNode(unsigned int hostid)
 {
 	unregisterNode(hostid);
@@ -390,29 +738,30 @@ void GanttStatusView::checkNode(unsigned int hostid)
         return;
     }
 
-    if (mNodeMap.find(hostid) == mNodeMap.end()) {
-        registerNode(hostid)->update(IdleJob());
+    if (!mNodes.contains(hostid)) {
+        GanttProgress *slot = registerNode(hostid);
+        slot->update(IdleJob());
+        updateFreeBit(slot);
     }
-    unsigned int max_kids = hostInfoManager()->maxJobs(hostid);
-    for (unsigned int i = mNodeMap[hostid].count();
-         i < max_kids;
-         ++i) {
-        registerNode(hostid)->update(IdleJob());
+    const int max_kids = hostInfoManager()->maxJobs(hostid);
+    for (int i = mNodes.value(hostid).slots.count(); i < max_kids; ++i) {
+        GanttProgress *slot = registerNode(hostid);
+        slot->update(IdleJob());
+        updateFreeBit(slot);
     }
 
-    mAgeMap[hostid] = 0;
+    touchNode(hostid);
 
-    SlotList slotList = mNodeMap[hostid];   // make a copy
+    const SlotList slotList = mNodes.value(hostid).slots;   // make a copy
     int to_remove = slotList.count() - max_kids;
     if (to_remove <= 0) {
         return;
     }
 
-    QListIterator<GanttProgress *> it2(slotList);
-    it2.toBack();
-    while (it2.hasPrevious()) {
-        GanttProgress *progress = it2.previous();
-        if (progress->isFree() && progress->fullyIdle()) {
+    for (int i = slotList.count() - 1; i >= 0; --i) {
+        GanttProgress *progress = slotList.at(i);
+        // The history of a slot keeps growing, whether it can go depends only on the current job
+        if (progress->isFree() && !progress->hasJob()) {
             removeSlot(hostid, progress);
             if (--to_remove == 0) {
                 return;
@@ -427,147 +776,184 @@ GanttProgress *GanttStatusView::registerNode(unsigned int hostid)
 
     QColor color = hostColor(hostid);
 
-    QVBoxLayout *nodeLayout;
+    NodeSlots &node = mNodes[hostid];
 
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
+    if (!node.layout) {
         static int lastRow = 0;
         ++lastRow;
 
-        nodeLayout = new QVBoxLayout();
-        nodeLayout->setObjectName(QStringLiteral("%1_layout").arg(hostid));
-        m_topLayout->addLayout(nodeLayout, lastRow, 1);
-        mNodeLayouts.insert(hostid, nodeLayout);
-        mNodeRows.insert(hostid, lastRow);
-    } else {
-        nodeLayout = it.value();
+        node.layout = new QVBoxLayout();
+        node.layout->setObjectName(QStringLiteral("%1_layout").arg(hostid));
+        m_topLayout->addLayout(node.layout, lastRow, 1);
+        node.row = lastRow;
     }
 
-    NodeRowMap::ConstIterator rowIt = mNodeRows.constFind(hostid);
-    if (rowIt == mNodeRows.constEnd()) {
-    } else {
-        int row = *rowIt;
-        NodeLabelMap::ConstIterator labelIt = mNodeLabels.constFind(hostid);
-        if (labelIt == mNodeLabels.constEnd()) {
-            QString name = nameForHost(hostid);
-            auto l = new QLabel(name, mTopWidget);
-            QPalette palette = l->palette();
-            palette.setColor(l->foregroundRole(), color);
-            palette.setColor(l->backgroundRole(), Qt::white);
-            l->setPalette(palette);
-            m_topLayout->addWidget(l, row, 0);
-
-            QFont f = l->font();
-            f.setBold(true);
-            l->setFont(f);
-
-            l->show();
-            mNodeLabels.insert(hostid, l);
-        }
+    if (!node.label) {
+        QString name = nameForHost(hostid);
+        auto l = new QLabel(name, mTopWidget);
+        QPalette palette = l->palette();
+        palette.setColor(l->foregroundRole(), color);
+        palette.setColor(l->backgroundRole(), Qt::white);
+        l->setPalette(palette);
+        m_topLayout->addWidget(l, node.row, 0);
+
+        QFont f = l->font();
+        f.setBold(true);
+        l->setFont(f);
+
+        l->show();
+        node.label = l;
     }
 
     auto w = new GanttProgress(this, mTopWidget);
     w->setMinimumHeight(mMinimumProgressHeight);
-    nodeLayout->addWidget(w);
+    node.layout->addWidget(w);
 
-    mNodeMap[hostid].append(w);
-    mAgeMap[hostid] = 0;
+    w->setSlot(hostid, node.slots.size());
+    node.slots.append(w);
+    if (node.freeBits.size() * 64 < node.slots.size()) {
+        node.freeBits.append(0);
+    }
 
-    m_topLayout->setRowStretch(mNodeRows[hostid], mNodeMap[hostid].size());
+    m_topLayout->setRowStretch(node.row, node.slots.size());
 
     w->show();
 
+    touchNode(hostid);
+
     return w;
 }
 
 void GanttStatusView::removeSlot(unsigned int hostid, GanttProgress *slot)
 {
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
+    NodeMap::Iterator it = mNodes.find(hostid);
+    if (it == mNodes.end()) {
         return;
     }
 
-    mNodeMap[hostid].removeAll(slot);
-    JobMap newJobMap;
-    for (QMap<unsigned int, GanttProgress *>::Iterator it = mJobMap.begin();
-         it != mJobMap.end();  // QMap::remove doesn't return an iterator like
-         ++it) {               // e.g. in QValueList, and I'm not sure if 'it'
-        if ((*it) != slot) {   // or '++it' would be still valid, so let's copy
-            newJobMap[it.key()] = *it;   // still valid items to a new map
-        }
+    // Move the last slot into the freed position, so neither the slot list
+    // nor the free bitmap has to be shifted
+    NodeSlots &node = it.value();
+    const int index = slot->slotIndex();
+    const int last = node.slots.size() - 1;
+    Q_ASSERT(node.slots.at(index) == slot);
+    if (index != last) {
+        GanttProgress *moved = node.slots.at(last);
+        node.slots[index] = moved;
+        moved->setSlot(hostid, index);
+        setSlotFree(node, index, moved->isFree());
     }
+    setSlotFree(node, last, false);
+    node.slots.removeLast();
+    node.freeBits.resize((node.slots.size() + 63) / 64);
 
-    mJobMap = newJobMap;
+    if (slot->hasJob()) {
+        mJobSlots.remove(slot->jobId());
+    }
 
-    m_topLayout->setRowStretch(mNodeRows[hostid], mNodeMap[hostid].size());
+    m_topLayout->setRowStretch(node.row, node.slots.size());
     delete slot;
 }
 
 void GanttStatusView::unregisterNode(unsigned int hostid)
 {
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
+    NodeMap::Iterator it = mNodes.find(hostid);
+    if (it == mNodes.end()) {
         return;
     }
-    while (!mNodeMap[hostid].isEmpty())
-        removeSlot(hostid, mNodeMap[hostid].first());
-    NodeLabelMap::Iterator labelIt = mNodeLabels.find(hostid);
-    if (labelIt != mNodeLabels.end()) {
-        delete *labelIt;
-        mNodeLabels.erase(labelIt);
+    while (!it->slots.isEmpty())
+        removeSlot(hostid, it->slots.last());
+    delete it->label;
+    it->label = nullptr;
+    if (it->ageBucket >= 0) {
+        mAgeWheel[it->ageBucket].remove(hostid);
+        it->ageBucket = -1;
     }
-    mAgeMap[hostid] = -1;
 }
 
 void GanttStatusView::updateGraphs()
 {
+    updateHistoryBar();
+
     NodeMap::ConstIterator it;
-    for (it = mNodeMap.constBegin(); it != mNodeMap.constEnd(); ++it) {
+    for (it = mNodes.constBegin(); it != mNodes.constEnd(); ++it) {
         SlotList::ConstIterator it2;
-        for (it2 = (*it).constBegin(); it2 != (*it).constEnd(); ++it2) {
+        for (it2 = (*it).slots.constBegin(); it2 != (*it).slots.constEnd(); ++it2) {
             (*it2)->progress();
         }
     }
 }
 
+void GanttStatusView::updateHistoryBar()
+{
+    const qint64 now = clock();
+    const int maximum = int(qMin(now, historyLength()) / 1000);
+    const int secondsBack = (mViewTime < 0) ? 0 : int((now - mViewTime) / 1000);
+
+    // Keep the slider in sync with the passing time without re-anchoring the view
+    const QSignalBlocker blocker(mHistoryBar);
+    mHistoryBar->setRange(0, maximum);
+    mHistoryBar->setPageStep(qMax(1, mScrollArea->viewport()->width() / mPixelsPerSecond));
+    mHistoryBar->setValue(secondsBack);
+
+    mTimeScale->setTimeOffset(clock() - viewTime());
+}
+
+void GanttStatusView::slotHistoryScrolled(int secondsBack)
+{
+    mViewTime = (secondsBack <= 0) ? -1 : qMax(qint64(0), clock() - qint64(secondsBack) * 1000);
+    updateGraphs();
+}
+
 void GanttStatusView::stop()
 {
     mRunning = false;
-    m_progressTimer->stop();
-    m_ageTimer->stop();
+    FrameScheduler::instance()->setCallbackEnabled(m_progressCallback, false);
+    FrameScheduler::instance()->setCallbackEnabled(m_ageCallback, false);
 }
 
 void GanttStatusView::start()
 {
     mRunning = true;
-    m_progressTimer->start(mUpdateInterval);
-    m_ageTimer->start(10000);
+    FrameScheduler::instance()->setCallbackEnabled(m_progressCallback, true);
+    FrameScheduler::instance()->setCallbackEnabled(m_ageCallback, true);
 }
 
 void GanttStatusView::checkAge()
 {
-    QList<unsigned int> to_unregister;
-    for (AgeMap::Iterator it = mAgeMap.begin();
-         it != mAgeMap.end();
-         ++it) {
-        if (*it > 1) {
-            to_unregister.append(it.key());
-        } else if (*it < 0) {
-            ; // unregistered ones
-        } else {
-            ++(*it);
-        }
+    // Hosts are filed into the bucket of the tick they were last active in.
+    // Advancing the wheel reaches the bucket of hosts which have been quiet
+    // for AgeWheelSize ticks, which are the only ones that need visiting.
+    mAgeWheelPos = (mAgeWheelPos + 1) % AgeWheelSize;
+    const QSet<unsigned int> expired = std::exchange(mAgeWheel[mAgeWheelPos], QSet<unsigned int>());
+    for (unsigned int hostid : expired) {
+        mNodes[hostid].ageBucket = -1;
+        unregisterNode(hostid);
     }
 
-    for (QList<unsigned int>::ConstIterator it = to_unregister.constBegin();
-         it != to_unregister.constEnd();
-         ++it) {
-        unregisterNode(*it);
+    // Forget the file names which dropped out of the history of all slots
+    if (mTextCache.needsSweep()) {
+        QSet<int> usedIds;
+        for (const NodeSlots &node : std::as_const(mNodes)) {
+            for (GanttProgress *slot : node.slots) {
+                slot->collectPathIds(usedIds);
+            }
+        }
+        mTextCache.sweep(usedIds);
     }
 }
 
 void GanttStatusView::configureView()
 {
+    if (!mConfigDialog) {
+        mConfigDialog = new GanttConfigDialog(m_widget.data());
+        mConfigDialog->setTimeScaleVisible(!mTimeScale->isHidden());
+        mConfigDialog->setPixelsPerSecond(mPixelsPerSecond);
+        mConfigDialog->setHistoryHours(mHistoryHours);
+        connect(mConfigDialog, SIGNAL(configChanged()),
+                SLOT(slotConfigChanged()));
+    }
+
     mConfigDialog->show();
     mConfigDialog->raise();
 }
@@ -579,4 +965,7 @@ void GanttStatusView::slotConfigChanged()
     } else {
         mTimeScale->hide();
     }
+
+    mHistoryHours = mConfigDialog->historyHours();
+    setPixelsPerSecond(mConfigDialog->pixelsPerSecond());
 }
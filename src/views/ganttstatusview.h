@@ -27,12 +27,20 @@
 #include <qdialog.h>
 #include <qmap.h>
 #include <qpixmap.h>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QHash>
+#include <QSet>
 #include <QScrollArea>
 #include <qlist.h>
 
+class GanttStatusView;
+
 class QCheckBox;
 class QGridLayout;
-class QTimer;
+class QScrollBar;
+class QSpinBox;
 class QVBoxLayout;
 
 class GanttConfigDialog
@@ -43,12 +51,21 @@ public:
     explicit GanttConfigDialog(QWidget *parent);
 
     bool isTimeScaleVisible();
+    void setTimeScaleVisible(bool visible);
+
+    int pixelsPerSecond() const;
+    void setPixelsPerSecond(int pixelsPerSecond);
+
+    int historyHours() const;
+    void setHistoryHours(int hours);
 
 signals:
     void configChanged();
 
 private:
     QCheckBox *mTimeScaleVisibleCheck;
+    QSpinBox *mPixelsPerSecondSpin;
+    QSpinBox *mHistoryHoursSpin;
 };
 
 class GanttTimeScaleWidget
@@ -60,11 +77,91 @@ public:
 
     void setPixelsPerSecond(int);
 
+    /// Sets how many milliseconds in the past the left border of the scale is
+    void setTimeOffset(qint64 msecs);
+
 protected:
     void paintEvent(QPaintEvent *e) override;
 
 private:
     int mPixelsPerSecond{40};
+    qint64 mTimeOffset{0};
+};
+
+/**
+ * Elided and pre-rendered file names shared by all slots of the Gantt view
+ *
+ * Every file name is shaped once per font and the advance up to each of its
+ * grapheme boundaries is kept, so finding the elision point for a given
+ * width is a binary search. The rendered text is cached per (path id, font,
+ * width bucket) on a transparent pixmap, so every slot showing the same file
+ * blits the same pixmap.
+ *
+ * Path ids are never reused. The paths no slot shows any more are dropped by
+ * sweep(), cached texts of dropped ids just age out of the caches.
+ */
+class GanttTextCache
+{
+public:
+    GanttTextCache();
+
+    /// Interns @p path, returns the id to pass to text()
+    int pathId(const QString &path);
+
+    /// Enough paths were interned since the last sweep to make another one worthwhile
+    bool needsSweep() const;
+    /// Drops all interned paths but @p usedIds
+    void sweep(const QSet<int> &usedIds);
+
+    /**
+     * Returns the file name of @p pathId, elided with "..." to fit in
+     * @p width pixels, rendered in @p color, or a null pixmap if not even
+     * the ellipsis fits.
+     */
+    QPixmap text(int pathId, const QFont &font, int width, int height, const QColor &color);
+
+private:
+    struct Layout
+    {
+        /// Ends of the grapheme clusters of the file name, 0 first
+        QVector<int> lengths;
+        /// widths[i] is the shaped advance of the first lengths[i] characters
+        QVector<int> widths;
+        int ellipsisWidth{0};
+    };
+
+    struct PixmapKey
+    {
+        int pathId;
+        int fontId;
+        int width;
+        int height;
+        QRgb color;
+
+        bool operator==(const PixmapKey &other) const
+        {
+            return pathId == other.pathId && fontId == other.fontId
+                   && width == other.width && height == other.height
+                   && color == other.color;
+        }
+
+        friend size_t qHash(const PixmapKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.pathId, key.fontId, key.width, key.height, key.color);
+        }
+    };
+
+    int fontId(const QFont &font);
+    const Layout *layout(int pathId, int fontId, const QFont &font);
+
+    QHash<QString, int> m_pathIds;
+    QHash<int, QString> m_fileNames;
+    int m_nextPathId{0};
+    /// Paths left after the last sweep
+    int m_sweptPathCount{0};
+    QVector<QFont> m_fonts;
+    QCache<quint64, Layout> m_layouts;
+    QCache<PixmapKey, QPixmap> m_pixmaps;
 };
 
 class GanttProgress
@@ -72,51 +169,68 @@ class GanttProgress
 {
     Q_OBJECT
 public:
-    GanttProgress(StatusView *statusView,
+    GanttProgress(GanttStatusView *statusView,
                   QWidget *parent);
 
     bool isFree() const { return mIsFree; }
     bool fullyIdle() const { return m_jobs.count() == 1 && isFree(); }
 
+    // Bookkeeping of GanttStatusView: the host and position in its slot
+    // list this slot is registered at, and the job currently assigned to it
+    unsigned int hostId() const { return mHostId; }
+    int slotIndex() const { return mSlotIndex; }
+    void setSlot(unsigned int hostid, int index) { mHostId = hostid; mSlotIndex = index; }
+
+    bool hasJob() const { return mHasJob; }
+    unsigned int jobId() const { return mJobId; }
+    void setJobId(unsigned int jobId) { mJobId = jobId; mHasJob = true; }
+    void clearJobId() { mHasJob = false; }
+
+    /// Adds the path ids of the jobs kept in the history, see GanttTextCache::sweep()
+    void collectPathIds(QSet<int> &ids) const;
+
 public slots:
     void progress();
     void update(const Job &job);
 
 protected:
     void paintEvent(QPaintEvent *e) override;
-    void resizeEvent(QResizeEvent *e) override;
 
 private:
-    void adjustGraph();
+    void appendJob(const Job &job, qint64 time);
+    void pruneHistory();
     void drawGraph(QPainter &p);
     QColor colorForStatus(const Job &job) const;
 
+    /**
+     * One job (or idle period) this slot has processed, positioned by the
+     * monotonic timestamps of its start and end.
+     */
     struct JobData
     {
-        JobData(Job j, int c)
+        JobData(Job j, qint64 s, int p)
             : job(std::move(j))
-            , clock(c)
-            , next_text_width(0) {}
-        JobData() {} // stupid QValueList
-
-        bool operator==(const JobData &d)
-        {
-            return job == d.job && clock == d.clock;
-        }
+            , start(s)
+            , pathId(p) {}
+        JobData() {}
 
         Job job;
-        int clock;
-        mutable int next_text_width;
-        mutable QPixmap text_cache;
+        qint64 start{0};
+        qint64 end{-1}; ///< -1 while the job is still running
+        int pathId{-1}; ///< see GanttTextCache::pathId()
     };
 
-    StatusView *mStatusView;
-
-    QList<JobData> m_jobs;
+    GanttStatusView *mStatusView;
 
-    int mClock{0};
+    /// Sorted by start time, oldest first; the intervals never overlap
+    QVector<JobData> m_jobs;
 
     bool mIsFree{true};
+
+    unsigned int mHostId{0};
+    int mSlotIndex{-1};
+    unsigned int mJobId{0};
+    bool mHasJob{false};
 };
 
 class GanttStatusView
@@ -125,7 +239,7 @@ class GanttStatusView
     Q_OBJECT
 public:
     explicit GanttStatusView(QObject *parent = nullptr);
-    ~GanttStatusView() override {}
+    ~GanttStatusView() override;
 
     QString id() const override { return QStringLiteral("gantt"); }
 
@@ -141,46 +255,94 @@ public:
 
     QWidget *widget() const override;
 
+    /// Monotonic time in milliseconds since the view was created
+    qint64 clock() const { return mClock.elapsed(); }
+    /// Time shown at the left border of the graphs, follows clock() unless scrolled back
+    qint64 viewTime() const { return mViewTime < 0 ? clock() : mViewTime; }
+    int pixelsPerSecond() const { return mPixelsPerSecond; }
+    /// How long finished jobs are kept for scrolling back, in milliseconds
+    qint64 historyLength() const { return qint64(mHistoryHours) * 3600 * 1000; }
+
+    void setPixelsPerSecond(int pixelsPerSecond);
+
+    GanttTextCache *textCache() { return &mTextCache; }
+
+    void readSettings();
+    void writeSettings();
+
 public slots:
     void update(const Job &job) override;
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     void slotConfigChanged();
+    void slotHistoryScrolled(int secondsBack);
     void updateGraphs();
     void checkAge();
 
 private:
+    using SlotList = QVector<GanttProgress *>;
+
+    struct NodeSlots
+    {
+        SlotList slots;
+        /// One bit per entry in slots, set while that slot is free
+        QVector<quint64> freeBits;
+        QVBoxLayout *layout{nullptr};
+        QWidget *label{nullptr};
+        int row{0};
+        /// Index into mAgeWheel, -1 if not ageing
+        int ageBucket{-1};
+    };
+
     GanttProgress *registerNode(unsigned int hostid);
     void removeSlot(unsigned int hostid, GanttProgress *slot);
     void unregisterNode(unsigned int hostid);
+    void updateHistoryBar();
+
+    GanttProgress *findFreeSlot(unsigned int hostid) const;
+    void setSlotFree(NodeSlots &node, int index, bool free);
+    void updateFreeBit(GanttProgress *slot);
+    void touchNode(unsigned int hostid);
 
-    GanttConfigDialog *mConfigDialog;
+    /// Created when the view is configured for the first time
+    GanttConfigDialog *mConfigDialog{nullptr};
 
-    QScopedPointer<QScrollArea> m_widget;
+    QScopedPointer<QWidget> m_widget;
+    QScrollArea *mScrollArea;
+    QScrollBar *mHistoryBar;
     QWidget *mTopWidget;
     QGridLayout *m_topLayout;
 
     GanttTimeScaleWidget *mTimeScale;
 
-    using SlotList = QList<GanttProgress *>;
-    using NodeMap = QMap<unsigned int, SlotList>;
-    NodeMap mNodeMap;
-    using AgeMap = QMap<unsigned int, int>;
-    AgeMap mAgeMap;
-    using JobMap = QMap<unsigned int, GanttProgress *>;
-    JobMap mJobMap;
-    using NodeLayoutMap = QMap<unsigned int, QVBoxLayout *>;
-    NodeLayoutMap mNodeLayouts;
-    using NodeRowMap = QMap<unsigned int, int>;
-    NodeRowMap mNodeRows;
-    using NodeLabelMap = QMap<unsigned int, QWidget *>;
-    NodeLabelMap mNodeLabels;
-    QTimer *m_progressTimer;
-    QTimer *m_ageTimer;
-
-    bool mRunning;
+    using NodeMap = QHash<unsigned int, NodeSlots>;
+    NodeMap mNodes;
+    /// Maps a running job to the slot it is shown in, see GanttProgress::jobId()
+    using JobSlotMap = QHash<unsigned int, GanttProgress *>;
+    JobSlotMap mJobSlots;
+
+    /// Hosts which haven't been active for this many checkAge() ticks get removed
+    static const int AgeWheelSize = 3;
+    QSet<unsigned int> mAgeWheel[AgeWheelSize];
+    int mAgeWheelPos{0};
+
+    /// Frame scheduler callbacks of updateGraphs() and checkAge()
+    int m_progressCallback;
+    int m_ageCallback;
+
+    QElapsedTimer mClock;
+    qint64 mViewTime{-1};
+
+    GanttTextCache mTextCache;
+
+    bool mRunning{false};
 
     int mUpdateInterval;
+    int mPixelsPerSecond{40};
+    int mHistoryHours{2};
 
     int mMinimumProgressHeight;
 };
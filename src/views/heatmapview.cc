@@ -0,0 +1,255 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "heatmapview.h"
+
+#include "framescheduler.h"
+#include "hostinfo.h"
+#include "hostutilization.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWidget>
+
+#include <algorithm>
+
+namespace {
+
+const int RenderInterval = 2000;
+const int LabelMargin = 4;
+
+}
+
+/**
+ * Paints the rasterized heatmap scaled to the widget, so all hosts fit
+ */
+class HeatmapCanvas
+    : public QWidget
+{
+public:
+    explicit HeatmapCanvas(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+        setMinimumHeight(100);
+    }
+
+    void setRows(const QStringList &names);
+    void setImage(const QImage &image);
+
+protected:
+    void paintEvent(QPaintEvent *e) override;
+
+private:
+    QStringList m_names;
+    QImage m_image;
+    int m_labelWidth{0};
+};
+
+void HeatmapCanvas::setRows(const QStringList &names)
+{
+    m_names = names;
+    m_labelWidth = 0;
+    for (const QString &name : names) {
+        m_labelWidth = qMax(m_labelWidth, fontMetrics().horizontalAdvance(name));
+    }
+    m_labelWidth += 2 * LabelMargin;
+    QWidget::update();
+}
+
+void HeatmapCanvas::setImage(const QImage &image)
+{
+    m_image = image;
+    FrameScheduler::instance()->markDirty(this);
+}
+
+void HeatmapCanvas::paintEvent(QPaintEvent *e)
+{
+    QPainter p(this);
+    p.fillRect(e->rect(), palette().window());
+
+    if (m_names.isEmpty() || m_image.isNull()) {
+        return;
+    }
+
+    // Names only where the rows are high enough to read them
+    const qreal rowHeight = qreal(height()) / m_names.size();
+    const bool showNames = rowHeight >= fontMetrics().height();
+    const int labelWidth = showNames ? qMin(m_labelWidth, width() / 3) : 0;
+
+    p.drawImage(QRect(labelWidth, 0, width() - labelWidth, height()), m_image);
+
+    if (showNames) {
+        p.setPen(palette().color(QPalette::WindowText));
+        for (int row = 0; row < m_names.size(); ++row) {
+            const QRectF rect(LabelMargin, row * rowHeight, labelWidth - 2 * LabelMargin, rowHeight);
+            if (rect.bottom() < e->rect().top() || rect.top() > e->rect().bottom()) {
+                continue;
+            }
+            p.drawText(rect, Qt::AlignLeft | Qt::AlignVCenter,
+                       fontMetrics().elidedText(m_names.at(row), Qt::ElideRight, rect.width()));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HeatmapView implementation
+////////////////////////////////////////////////////////////////////////////////
+
+HeatmapView::HeatmapView(QObject *parent)
+    : StatusView(parent)
+    , m_widget(new HeatmapCanvas)
+{
+    // Idle is the base colour, then from blue over green and yellow to red
+    m_palette[0] = m_widget->palette().color(QPalette::Base).rgb();
+    for (int i = 1; i < 256; ++i) {
+        const qreal level = i / 255.0;
+        m_palette[i] = QColor::fromHsvF(0.66 * (1.0 - level), 0.3 + 0.7 * level, 0.95).rgb();
+    }
+
+    m_renderCallback = FrameScheduler::instance()->addCallback(this, [this]() { render(); }, RenderInterval, false);
+    start();
+
+    createKnownHosts();
+}
+
+HeatmapView::~HeatmapView()
+{
+}
+
+QWidget *HeatmapView::widget() const
+{
+    return m_widget.data();
+}
+
+void HeatmapView::setMonitor(Monitor *monitor)
+{
+    StatusView::setMonitor(monitor);
+
+    if (monitor) {
+        createKnownHosts();
+    }
+}
+
+void HeatmapView::stop()
+{
+    FrameScheduler::instance()->setCallbackEnabled(m_renderCallback, false);
+}
+
+void HeatmapView::start()
+{
+    FrameScheduler::instance()->setCallbackEnabled(m_renderCallback, true);
+    render();
+}
+
+void HeatmapView::render()
+{
+    if (m_hosts.isEmpty() || !monitor()) {
+        m_widget->setImage(QImage());
+        return;
+    }
+
+    if (m_image.width() != HostUtilization::BucketCount || m_image.height() != m_hosts.size()) {
+        m_image = QImage(HostUtilization::BucketCount, m_hosts.size(), QImage::Format_RGB32);
+    }
+
+    const HostUtilization *utilization = monitor()->hostUtilization();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    float levels[HostUtilization::BucketCount];
+    for (int row = 0; row < m_hosts.size(); ++row) {
+        auto *line = reinterpret_cast<QRgb *>(m_image.scanLine(row));
+        if (!utilization->levels(m_hosts.at(row).hostId, now, levels)) {
+            std::fill(line, line + HostUtilization::BucketCount, m_palette[0]);
+            continue;
+        }
+
+        // Shares to palette indexes, a plain loop over the scan line the
+        // compiler can keep in registers
+        for (int column = 0; column < HostUtilization::BucketCount; ++column) {
+            line[column] = m_palette[qBound(0, int(levels[column] * 255.0f + 0.5f), 255)];
+        }
+    }
+
+    m_widget->setImage(m_image);
+}
+
+void HeatmapView::createKnownHosts()
+{
+    if (!hostInfoManager()) {
+        return;
+    }
+
+    const HostInfoManager::HostMap hosts(hostInfoManager()->hostMap());
+    for (auto it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
+        checkNode(it.key());
+    }
+}
+
+void HeatmapView::checkNode(unsigned int hostid)
+{
+    const HostInfo *info = hostInfoManager()->find(hostid);
+    if (!info || info->isOffline()) {
+        removeNode(hostid);
+        return;
+    }
+
+    HostRow host;
+    const int index = m_hostIndex.value(hostid, -1);
+    if (index >= 0) {
+        if (m_hosts.at(index).name == info->name()) {
+            return;
+        }
+        // Renamed, moves to its new place
+        host = m_hosts.takeAt(index);
+    } else {
+        host.hostId = hostid;
+    }
+    host.name = info->name();
+
+    const auto pos = std::lower_bound(m_hosts.begin(), m_hosts.end(), host.name,
+                                      [](const HostRow &row, const QString &name) {
+                                          return row.name < name;
+                                      });
+    m_hosts.insert(pos, host);
+    hostsChanged();
+}
+
+void HeatmapView::removeNode(unsigned int hostid)
+{
+    const int index = m_hostIndex.value(hostid, -1);
+    if (index < 0) {
+        return;
+    }
+
+    m_hosts.remove(index);
+    hostsChanged();
+}
+
+void HeatmapView::hostsChanged()
+{
+    QStringList names;
+    names.reserve(m_hosts.size());
+    m_hostIndex.clear();
+    for (int i = 0; i < m_hosts.size(); ++i) {
+        m_hostIndex.insert(m_hosts.at(i).hostId, i);
+        names.append(m_hosts.at(i).name);
+    }
+    m_widget->setRows(names);
+}
@@ -0,0 +1,84 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_HEATMAPVIEW_H
+#define ICEMON_HEATMAPVIEW_H
+
+#include "statusview.h"
+
+#include <QHash>
+#include <QImage>
+#include <QScopedPointer>
+#include <QVector>
+
+class HeatmapCanvas;
+
+/**
+ * Utilization of every host over the last hour
+ *
+ * Rows are hosts, columns are one minute buckets and the colour is the
+ * share of the job slots of the host which were busy in that minute. The
+ * busy time is counted by the HostUtilization of the monitor, the view only
+ * rasterizes it, so nothing is missed while the view is paused.
+ */
+class HeatmapView
+    : public StatusView
+{
+    Q_OBJECT
+
+public:
+    explicit HeatmapView(QObject *parent = nullptr);
+    ~HeatmapView() override;
+
+    QWidget *widget() const override;
+    QString id() const override { return QStringLiteral("heatmap"); }
+
+    void setMonitor(Monitor *monitor) override;
+    void checkNode(unsigned int hostid) override;
+    void removeNode(unsigned int hostid) override;
+
+    bool isPausable() override { return true; }
+    void stop() override;
+    void start() override;
+
+private Q_SLOTS:
+    void render();
+
+private:
+    struct HostRow
+    {
+        unsigned int hostId{0};
+        QString name;
+    };
+
+    void createKnownHosts();
+    void hostsChanged();
+
+    QScopedPointer<HeatmapCanvas> m_widget;
+
+    /// Sorted by name
+    QVector<HostRow> m_hosts;
+    QHash<unsigned int, int> m_hostIndex;
+
+    /// Frame scheduler callback of render()
+    int m_renderCallback;
+    QRgb m_palette[256];
+    QImage m_image;
+};
+
+#endif // ICEMON_HEATMAPVIEW_H
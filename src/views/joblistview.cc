@@ -34,6 +34,8 @@ JobListView::JobListView(QWidget *parent)
     setAllColumnsShowFocus(true);
     setRootIsDecorated(false);
     setSortingEnabled(true);
+    // All rows have the same height, lets the view skip measuring them
+    setUniformRowHeights(true);
     setWindowTitle(tr("Jobs"));
 }
 
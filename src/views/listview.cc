@@ -25,8 +25,12 @@
 
 #include "joblistview.h"
 #include "models/joblistmodel.h"
+#include "models/joblistsortmodel.h"
 
 #include <QBoxLayout>
+#include <QLineEdit>
+#include <QSettings>
+#include <QTimer>
 
 ListStatusView::ListStatusView(QObject *parent)
     : StatusView(parent)
@@ -34,15 +38,53 @@ ListStatusView::ListStatusView(QObject *parent)
     , mJobsListView(new JobListView(m_widget.data()))
 {
     mJobsListModel = new JobListModel(this);
-    mSortedJobsListModel = new JobListSortFilterProxyModel(this);
-    mSortedJobsListModel->setDynamicSortFilter(true);
+    mSortedJobsListModel = new JobListSortModel(this);
     mSortedJobsListModel->setSourceModel(mJobsListModel);
 
     mJobsListView->setModel(mSortedJobsListModel);
 
+    auto filterEdit = new QLineEdit(m_widget.data());
+    filterEdit->setPlaceholderText(tr("Filter by file name"));
+    filterEdit->setClearButtonEnabled(true);
+    // Filtered once typing pauses, not on every keystroke
+    mFilterTimer = new QTimer(this);
+    mFilterTimer->setSingleShot(true);
+    mFilterTimer->setInterval(200);
+    connect(filterEdit, &QLineEdit::textChanged, mFilterTimer, qOverload<>(&QTimer::start));
+    connect(mFilterTimer, &QTimer::timeout, this, [this, filterEdit]() {
+        mSortedJobsListModel->setFileNameFilter(filterEdit->text());
+    });
+
     auto topLayout = new QVBoxLayout(m_widget.data());
     topLayout->setContentsMargins({});
+    topLayout->setSpacing(0);
+    topLayout->addWidget(filterEdit);
     topLayout->addWidget(mJobsListView);
+
+    readSettings();
+}
+
+ListStatusView::~ListStatusView()
+{
+    writeSettings();
+}
+
+void ListStatusView::readSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    // Off unless set, a limit keeps a monitor left open for days from growing without bounds
+    mJobsListModel->setMemoryLimit(settings.value(QStringLiteral("maxMemoryMiB"), 0).toLongLong() * 1024 * 1024);
+    settings.endGroup();
+}
+
+void ListStatusView::writeSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    settings.setValue(QStringLiteral("maxMemoryMiB"), mJobsListModel->memoryLimit() / (1024 * 1024));
+    settings.endGroup();
+    settings.sync();
 }
 
 StatusView::Options ListStatusView::options() const
@@ -57,7 +99,27 @@ QWidget *ListStatusView::widget() const
 
 void ListStatusView::setMonitor(Monitor *monitor)
 {
+    mJobsListModel->setMonitor(monitor);
+
     StatusView::setMonitor(monitor);
+}
 
-    mJobsListModel->setMonitor(monitor);
+void ListStatusView::stop()
+{
+    mJobsListModel->setUpdatesEnabled(false);
+}
+
+void ListStatusView::start()
+{
+    mJobsListModel->setUpdatesEnabled(true);
+}
+
+void ListStatusView::loadSnapshot(const QVector<Job> &jobs)
+{
+    mJobsListModel->setJobs(jobs);
+}
+
+void ListStatusView::applyDelta(const JobStore::Delta &delta)
+{
+    mJobsListModel->updateJobs(delta.jobs);
 }
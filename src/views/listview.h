@@ -27,8 +27,9 @@
 #include <QWidget>
 
 class JobListModel;
+class JobListSortModel;
 class JobListView;
-class QSortFilterProxyModel;
+class QTimer;
 
 class ListStatusView
     : public StatusView
@@ -36,6 +37,10 @@ class ListStatusView
     Q_OBJECT
 public:
     explicit ListStatusView(QObject *parent);
+    ~ListStatusView() override;
+
+    void readSettings();
+    void writeSettings();
 
     Options options() const override;
     QWidget *widget() const override;
@@ -43,12 +48,21 @@ public:
 
     void setMonitor(Monitor *monitor) override;
 
+    bool isPausable() override { return true; }
+    void stop() override;
+    void start() override;
+
+protected:
+    void loadSnapshot(const QVector<Job> &jobs) override;
+    void applyDelta(const JobStore::Delta &delta) override;
+
 private:
     QScopedPointer<QWidget> m_widget;
 
     JobListView *mJobsListView;
     JobListModel *mJobsListModel;
-    QSortFilterProxyModel *mSortedJobsListModel;
+    JobListSortModel *mSortedJobsListModel;
+    QTimer *mFilterTimer;
 };
 
 #endif
@@ -0,0 +1,315 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sessionview.h"
+
+#include "framescheduler.h"
+#include "hostinfo.h"
+#include "sessiondetector.h"
+
+#include <QBoxLayout>
+#include <QDateTime>
+#include <QHeaderView>
+#include <QListWidget>
+#include <QLocale>
+#include <QPainter>
+#include <QSet>
+#include <QSignalBlocker>
+#include <QSplitter>
+#include <QTreeWidget>
+
+namespace {
+
+const int Margin = 6;
+const int RefreshMsecs = 1000;
+
+/// More than this share of the job time spent waiting for a compile server
+const double WaitingShare = 0.3;
+/// Less parallel than this and the build mostly ran one job at a time
+const double SerialParallelism = 1.5;
+
+QString formatDuration(quint64 msecs)
+{
+    const quint64 secs = msecs / 1000;
+    if (secs >= 3600) {
+        return QStringLiteral("%1:%2:%3").arg(secs / 3600)
+               .arg((secs / 60) % 60, 2, 10, QLatin1Char('0'))
+               .arg(secs % 60, 2, 10, QLatin1Char('0'));
+    }
+    return QStringLiteral("%1:%2").arg(secs / 60).arg(secs % 60, 2, 10, QLatin1Char('0'));
+}
+
+}
+
+/**
+ * Paints the number of running jobs over the lifetime of a session
+ */
+class SessionProfile
+    : public QWidget
+{
+public:
+    explicit SessionProfile(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setMinimumHeight(60);
+    }
+
+    void setSession(const SessionDetector::Session &session)
+    {
+        m_profile = session.profile;
+        m_bucketMsecs = session.profileBucketMsecs;
+        m_wallMsecs = session.wallMsecs();
+        FrameScheduler::instance()->markDirty(this);
+    }
+
+    void clear()
+    {
+        m_profile.clear();
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+
+private:
+    QVector<quint64> m_profile;
+    qint64 m_bucketMsecs{1};
+    qint64 m_wallMsecs{0};
+};
+
+void SessionProfile::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette().base());
+
+    const QRect plot = rect().adjusted(Margin, Margin, -Margin, -Margin);
+    if (m_profile.isEmpty() || plot.width() <= 0 || plot.height() <= 0) {
+        return;
+    }
+
+    // The last bucket may only be partly over
+    QVector<double> running(m_profile.size());
+    double maximum = 1.0;
+    for (int i = 0; i < m_profile.size(); ++i) {
+        const qint64 length = qBound<qint64>(1, m_wallMsecs - i * m_bucketMsecs, m_bucketMsecs);
+        running[i] = double(m_profile.at(i)) / length;
+        maximum = qMax(maximum, running.at(i));
+    }
+
+    const QString maximumText = QLocale().toString(maximum, 'f', 1);
+    p.setPen(palette().color(QPalette::Text));
+    p.drawText(plot, Qt::AlignLeft | Qt::AlignTop, maximumText);
+
+    const int barWidth = qMax(1, plot.width() / running.size());
+    const QColor color = palette().color(QPalette::Highlight);
+    for (int i = 0; i < running.size(); ++i) {
+        const int height = qRound(running.at(i) * plot.height() / maximum);
+        p.fillRect(plot.left() + i * barWidth, plot.bottom() - height + 1, qMax(1, barWidth - 1), height, color);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SessionView implementation
+////////////////////////////////////////////////////////////////////////////////
+
+SessionView::SessionView(QObject *parent)
+    : StatusView(parent)
+    , m_widget(new QWidget)
+{
+    auto topLayout = new QVBoxLayout(m_widget.data());
+    topLayout->setContentsMargins({});
+
+    auto splitter = new QSplitter(Qt::Horizontal, m_widget.data());
+    topLayout->addWidget(splitter);
+
+    m_clientList = new QListWidget(splitter);
+    m_clientList->setSortingEnabled(true);
+
+    auto sessionWidget = new QWidget(splitter);
+    auto sessionLayout = new QVBoxLayout(sessionWidget);
+    sessionLayout->setContentsMargins({});
+
+    m_sessionTree = new QTreeWidget(sessionWidget);
+    m_sessionTree->setRootIsDecorated(false);
+    m_sessionTree->setAllColumnsShowFocus(true);
+    m_sessionTree->setHeaderLabels({
+        tr("Start"),
+        tr("Wall Time"),
+        tr("Jobs"),
+        tr("CPU Time"),
+        tr("Parallelism"),
+        tr("Local Only"),
+        tr("Waiting"),
+        tr("Assessment")
+    });
+    m_sessionTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    sessionLayout->addWidget(m_sessionTree, 1);
+
+    m_profile = new SessionProfile(sessionWidget);
+    sessionLayout->addWidget(m_profile);
+
+    splitter->setStretchFactor(1, 1);
+
+    connect(m_clientList, &QListWidget::currentItemChanged, this, &SessionView::refreshSessions);
+    connect(m_sessionTree, &QTreeWidget::currentItemChanged, this, &SessionView::refreshProfile);
+    m_refreshCallback = FrameScheduler::instance()->addCallback(this, [this]() { refresh(); }, RefreshMsecs);
+}
+
+SessionView::~SessionView()
+{
+}
+
+QWidget *SessionView::widget() const
+{
+    return m_widget.data();
+}
+
+void SessionView::setMonitor(Monitor *monitor)
+{
+    StatusView::setMonitor(monitor);
+
+    refresh();
+}
+
+void SessionView::stop()
+{
+    FrameScheduler::instance()->setCallbackEnabled(m_refreshCallback, false);
+}
+
+void SessionView::start()
+{
+    FrameScheduler::instance()->setCallbackEnabled(m_refreshCallback, true);
+    refresh();
+}
+
+void SessionView::refresh()
+{
+    if (!monitor()) {
+        return;
+    }
+
+    const QList<HostId> clients = monitor()->sessionDetector()->clients();
+    QSet<HostId> unlisted(clients.cbegin(), clients.cend());
+    for (int row = m_clientList->count() - 1; row >= 0; --row) {
+        const HostId client = m_clientList->item(row)->data(Qt::UserRole).toUInt();
+        if (!unlisted.remove(client)) {
+            delete m_clientList->takeItem(row);
+        }
+    }
+    for (HostId client : clients) {
+        if (unlisted.contains(client)) {
+            auto item = new QListWidgetItem(nameForHost(client), m_clientList);
+            item->setData(Qt::UserRole, client);
+        }
+    }
+
+    refreshSessions();
+}
+
+void SessionView::refreshSessions()
+{
+    const QListWidgetItem *clientItem = m_clientList->currentItem();
+    if (!clientItem || !monitor()) {
+        m_sessionTree->clear();
+        m_profile->clear();
+        return;
+    }
+
+    const HostId client = clientItem->data(Qt::UserRole).toUInt();
+    const QVector<SessionDetector::Session> sessions = monitor()->sessionDetector()->sessions(client);
+
+    // The newest session comes first, so rows move down as sessions start:
+    // the selection follows the start time of the session, not the row
+    const QTreeWidgetItem *currentItem = m_sessionTree->currentItem();
+    const QVariant selectedStart = currentItem ? currentItem->data(StartColumn, Qt::UserRole) : QVariant();
+
+    const QSignalBlocker blocker(m_sessionTree);
+    while (m_sessionTree->topLevelItemCount() > sessions.size()) {
+        delete m_sessionTree->takeTopLevelItem(0);
+    }
+    while (m_sessionTree->topLevelItemCount() < sessions.size()) {
+        new QTreeWidgetItem(m_sessionTree);
+    }
+
+    const QLocale locale;
+    for (int i = 0; i < sessions.size(); ++i) {
+        const SessionDetector::Session &session = sessions.at(i);
+        QTreeWidgetItem *item = m_sessionTree->topLevelItem(sessions.size() - 1 - i);
+        const double parallelism = session.parallelism();
+        const quint64 jobMsecs = session.busyMsecs + session.waitMsecs;
+        const double waitShare = jobMsecs ? double(session.waitMsecs) / jobMsecs : 0.0;
+
+        QString assessment;
+        if (waitShare > WaitingShare) {
+            assessment = tr("waiting for compile servers");
+        } else if (parallelism < SerialParallelism) {
+            assessment = tr("serial");
+        } else {
+            assessment = tr("parallel");
+        }
+        if (!session.isIdle()) {
+            assessment = tr("%1 (running)").arg(assessment);
+        }
+
+        item->setText(StartColumn, locale.toString(QDateTime::fromMSecsSinceEpoch(session.start), QLocale::ShortFormat));
+        item->setData(StartColumn, Qt::UserRole, session.start);
+        item->setText(WallTimeColumn, formatDuration(session.wallMsecs()));
+        item->setText(JobsColumn, session.failedJobs
+                      ? tr("%1 (%2 failed)").arg(session.jobs).arg(session.failedJobs)
+                      : QString::number(session.jobs));
+        item->setText(CpuTimeColumn, formatDuration(session.cpuMsecs));
+        item->setText(ParallelismColumn, locale.toString(parallelism, 'f', 1));
+        item->setText(LocalColumn, tr("%1%").arg(qRound(100 * session.localFraction())));
+        item->setText(WaitingColumn, tr("%1%").arg(qRound(100 * waitShare)));
+        item->setText(AssessmentColumn, assessment);
+    }
+
+    QTreeWidgetItem *selectedItem = m_sessionTree->topLevelItemCount() > 0 ? m_sessionTree->topLevelItem(0) : nullptr;
+    for (int row = 0; selectedStart.isValid() && row < m_sessionTree->topLevelItemCount(); ++row) {
+        QTreeWidgetItem *item = m_sessionTree->topLevelItem(row);
+        if (item->data(StartColumn, Qt::UserRole) == selectedStart) {
+            selectedItem = item;
+            break;
+        }
+    }
+    if (selectedItem) {
+        m_sessionTree->setCurrentItem(selectedItem);
+    }
+    refreshProfile();
+}
+
+void SessionView::refreshProfile()
+{
+    const QListWidgetItem *clientItem = m_clientList->currentItem();
+    QTreeWidgetItem *sessionItem = m_sessionTree->currentItem();
+    if (!clientItem || !sessionItem || !monitor()) {
+        m_profile->clear();
+        return;
+    }
+
+    const QVector<SessionDetector::Session> sessions
+        = monitor()->sessionDetector()->sessions(clientItem->data(Qt::UserRole).toUInt());
+    const qint64 start = sessionItem->data(StartColumn, Qt::UserRole).toLongLong();
+    for (const SessionDetector::Session &session : sessions) {
+        if (session.start == start) {
+            m_profile->setSession(session);
+            return;
+        }
+    }
+    m_profile->clear();
+}
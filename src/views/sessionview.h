@@ -0,0 +1,80 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_SESSIONVIEW_H
+#define ICEMON_SESSIONVIEW_H
+
+#include "statusview.h"
+
+#include <QScopedPointer>
+
+class QListWidget;
+class QTreeWidget;
+class SessionProfile;
+
+/**
+ * Build sessions of every client and how parallel they really were
+ *
+ * The sessions come from the session detector of the monitor. Selecting
+ * a session shows how many jobs it kept running over its lifetime.
+ */
+class SessionView
+    : public StatusView
+{
+    Q_OBJECT
+
+public:
+    explicit SessionView(QObject *parent = nullptr);
+    ~SessionView() override;
+
+    QWidget *widget() const override;
+    QString id() const override { return QStringLiteral("sessions"); }
+
+    void setMonitor(Monitor *monitor) override;
+
+    bool isPausable() override { return true; }
+    void stop() override;
+    void start() override;
+
+private Q_SLOTS:
+    void refresh();
+    void refreshSessions();
+    void refreshProfile();
+
+private:
+    enum Column {
+        StartColumn,
+        WallTimeColumn,
+        JobsColumn,
+        CpuTimeColumn,
+        ParallelismColumn,
+        LocalColumn,
+        WaitingColumn,
+        AssessmentColumn,
+        _ColumnCount
+    };
+
+    QScopedPointer<QWidget> m_widget;
+    QListWidget *m_clientList;
+    QTreeWidget *m_sessionTree;
+    SessionProfile *m_profile;
+    /// Frame scheduler callback of refresh()
+    int m_refreshCallback;
+};
+
+#endif // ICEMON_SESSIONVIEW_H
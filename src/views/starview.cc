@@ -21,6 +21,7 @@
 
 #include "starview.h"
 
+#include "framescheduler.h"
 #include "hostinfo.h"
 #include "utils.h"
 #include <monitor.h>
@@ -37,12 +38,31 @@
 #include <qdir.h>
 #include <QSettings>
 #include <QResizeEvent>
+#include <QWheelEvent>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QDialogButtonBox>
+#include <QPainter>
 #include <QRegularExpression>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <math.h>
+#include <utility>
+
+namespace {
+// Zoom levels below which host labels respectively job halos are left out
+const qreal DotZoomLimit = 0.3;
+const qreal LabelZoomLimit = 0.55;
+const qreal MinZoom = 0.05;
+const qreal MaxZoom = 4.0;
+
+// Layout of the host slots, in scene coordinates
+const double MinRadius = 180;
+const double SlotSpacing = 120;
+const double RingSpacing = 90;
+}
 
 // TODO: This shouldn't be global
 static bool suppressDomain = false;
@@ -140,6 +160,59 @@ void StarViewConfigDialog::slotSuppressDomainName(bool b)
     configChanged();
 }
 
+HostHaloItem::HostHaloItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+{
+}
+
+void HostHaloItem::setBaseRect(const QRectF &rect)
+{
+    if (m_baseRect == rect) {
+        return;
+    }
+
+    prepareGeometryChange();
+    m_baseRect = rect;
+}
+
+void HostHaloItem::addJob(unsigned int jobId, const QColor &color)
+{
+    prepareGeometryChange();
+    m_rings.append({jobId, color});
+}
+
+void HostHaloItem::removeJob(unsigned int jobId)
+{
+    for (int i = 0; i < m_rings.size(); ++i) {
+        if (m_rings.at(i).jobId == jobId) {
+            prepareGeometryChange();
+            m_rings.remove(i);
+            return;
+        }
+    }
+}
+
+QRectF HostHaloItem::boundingRect() const
+{
+    const qreal margin = m_rings.size() * HostItem::HaloMargin + 1;
+    return m_baseRect.adjusted(-margin, -margin, margin, margin);
+}
+
+void HostHaloItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // Outermost ring first, the ring of the oldest job ends up closest to the box
+    for (int i = m_rings.size(); i > 0; --i) {
+        const QColor &color = m_rings.at(i - 1).color;
+        const qreal margin = i * HostItem::HaloMargin;
+        painter->setPen(color.darker(HostItem::PenDarkerFactor));
+        painter->setBrush(color);
+        painter->drawEllipse(m_baseRect.adjusted(-margin, -margin, margin, margin));
+    }
+}
+
 HostItem::HostItem(const QString &text)
     : QGraphicsItemGroup(nullptr)
     , mHostInfo(nullptr)
@@ -175,8 +248,12 @@ void HostItem::init()
     m_boxItem->setZValue(80);
     m_boxItem->setPen(QPen(Qt::NoPen));
 
+    m_haloItem = new HostHaloItem(this);
+    m_haloItem->setZValue(70);
+
     m_textItem = new QGraphicsTextItem(this);
     m_textItem->setZValue(100);
+    m_textItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 
     setHostColor(QColor(200, 200, 200));
 
@@ -243,8 +320,10 @@ void HostItem::updateName()
     mBaseHeight = rect.height() * M_SQRT2;
 
     m_boxItem->setRect(-baseXMargin(), -baseYMargin(), mBaseWidth, mBaseHeight);
+    m_haloItem->setBaseRect(m_boxItem->rect());
 
-    updateHalos();
+    // Keep the center where it was, the size of the text may have changed
+    setCenterPos(m_center.x(), m_center.y());
 }
 
 void HostItem::setFixedText(const QString &text)
@@ -259,11 +338,19 @@ void HostItem::setFixedText(const QString &text)
 
 void HostItem::setCenterPos(double x, double y)
 {
+    m_center = QPointF(x, y);
+
     // move all items (also the sub items)
     setPos(x - m_textItem->boundingRect().width() / 2, y - m_textItem->boundingRect().height() / 2);
     //  setPos( x, y );
 }
 
+void HostItem::setLevelOfDetail(LevelOfDetail level)
+{
+    m_textItem->setVisible(level >= LabelDetail);
+    m_haloItem->setVisible(level >= FullDetail);
+}
+
 void HostItem::update(const Job &job)
 {
     setIsCompiling(job.state == Job::Compiling);
@@ -287,70 +374,22 @@ void HostItem::update(const Job &job)
     }
 
     if (newJob) {
+        Q_ASSERT(mHostInfoManager);
         m_jobs.insert(job.id, job);
-        createJobHalo(job);
+        m_haloItem->addJob(job.id, mHostInfoManager->hostColor(job.client));
         updateName();
     } else if (finished) {
-        deleteJobHalo(job);
+        m_haloItem->removeJob(job.id);
         m_jobs.erase(it);
         updateName();
     }
 }
 
-void HostItem::createJobHalo(const Job &job)
-{
-    auto halo = new QGraphicsEllipseItem(
-        centerPosX(), centerPosY(), mBaseWidth, mBaseHeight,
-        this);
-
-    halo->setPen(QPen(Qt::NoPen));
-    halo->show();
-
-    m_jobHalos.insert(job, halo);
-
-    updateHalos();
-}
-
-void HostItem::deleteJobHalo(const Job &job)
-{
-    QMap<Job, QGraphicsEllipseItem *>::Iterator it = m_jobHalos.find(job);
-    if (it == m_jobHalos.end()) {
-        return;
-    }
-
-    QGraphicsEllipseItem *halo = *it;
-    delete halo;
-    m_jobHalos.erase(it);
-
-    updateHalos();
-}
-
-void HostItem::updateHalos()
-{
-    Q_ASSERT(m_jobHalos.isEmpty() || mHostInfoManager);
-
-    int count = 1;
-
-    QMap<Job, QGraphicsEllipseItem *>::Iterator it;
-    for (it = m_jobHalos.begin(); it != m_jobHalos.end(); ++it) {
-        QGraphicsEllipseItem *halo = it.value();
-        halo->setZValue(70 - count);
-        halo->setRect(halo->x() - baseXMargin() - count * HaloMargin, halo->y() - baseYMargin() - count * HaloMargin, mBaseWidth + count * HaloMargin * 2, mBaseHeight + count * HaloMargin * 2);
-        halo->setBrush(mHostInfoManager->hostColor(it.key().client));
-        halo->setPen(mHostInfoManager->hostColor(it.key().client).darker(PenDarkerFactor));
-        ++count;
-    }
-}
-
 StarView::StarView(QObject *parent)
     : StatusView(parent)
     , m_canvas(new QGraphicsScene)
     , m_widget(new StarViewGraphicsView(m_canvas, this))
 {
-    mConfigDialog = new StarViewConfigDialog(m_widget.data());
-    connect(mConfigDialog, SIGNAL(configChanged()),
-            SLOT(slotConfigChanged()));
-
     readSettings();
 
     m_widget->setScene(m_canvas);
@@ -366,8 +405,8 @@ void StarView::readSettings()
 {
     QSettings settings;
     settings.beginGroup(QStringLiteral("view_%1").arg(id()));
-    mConfigDialog->setNodesPerRing(settings.value(QStringLiteral("nodesPerRing"), 25).toInt());
-    mConfigDialog->setSuppressDomainName(settings.value(QStringLiteral("suppressDomainName"), true).toBool());
+    mNodesPerRing = settings.value(QStringLiteral("nodesPerRing"), 25).toInt();
+    suppressDomain = settings.value(QStringLiteral("suppressDomainName"), true).toBool();
     settings.endGroup();
 }
 
@@ -375,8 +414,8 @@ void StarView::writeSettings()
 {
     QSettings settings;
     settings.beginGroup(QStringLiteral("view_%1").arg(id()));
-    settings.setValue(QStringLiteral("nodesPerRing"), mConfigDialog->nodesPerRing());
-    settings.setValue(QStringLiteral("suppressDomainName"), mConfigDialog->suppressDomainName());
+    settings.setValue(QStringLiteral("nodesPerRing"), mNodesPerRing);
+    settings.setValue(QStringLiteral("suppressDomainName"), suppressDomain);
     settings.endGroup();
     settings.sync();
 }
@@ -384,7 +423,6 @@ void StarView::writeSettings()
 void StarView::update(const Job &job)
 {
     if (job.state == Job::WaitingForCS) {
-        m_widget->drawNodeStatus();
         return;
     }
 
@@ -399,6 +437,7 @@ void StarView::update(const Job &job)
     }
 
     hostItem->update(job);
+    m_widget->scheduleNodeStatus(hostItem);
 
     bool finished = job.state == Job::Finished || job.state == Job::Failed;
 
@@ -406,15 +445,16 @@ void StarView::update(const Job &job)
     it = mJobMap.find(job.id);
     if (it != mJobMap.end()) {
         (*it)->update(job);
+        m_widget->scheduleNodeStatus(*it);
         if (finished) {
             mJobMap.erase(it);
             unsigned int clientid = job.client;
             HostItem *clientItem = findHostItem(clientid);
             if (clientItem) {
                 clientItem->setIsActiveClient(false);
+                m_widget->scheduleNodeStatus(clientItem);
             }
         }
-        m_widget->drawNodeStatus();
         return;
     }
 
@@ -428,10 +468,9 @@ void StarView::update(const Job &job)
         if (clientItem) {
             clientItem->setClient(clientid);
             clientItem->setIsActiveClient(true);
+            m_widget->scheduleNodeStatus(clientItem);
         }
     }
-
-    m_widget->drawNodeStatus();
 }
 
 QList<HostItem *> StarView::hostItems() const
@@ -469,7 +508,6 @@ void StarView::checkNode(unsigned int hostid)
     HostItem *hostItem = findHostItem(hostid);
     if (!hostItem) {
         createHostItem(hostid);
-        m_widget->arrangeItems();
     }
 }
 
@@ -498,17 +536,19 @@ void StarView::removeNode(unsigned int hostid)
         mJobMap.remove(*it2);
     }
 
+    m_widget->removeHostItem(hostItem);
     delete hostItem->stateItem();
     delete hostItem;
-
-    m_widget->arrangeItems();
 }
 
 void StarView::updateSchedulerState(Monitor::SchedulerState state)
 {
     if (state == Monitor::Offline) {
+        m_widget->clearHostItems();
+
         QMap<unsigned int, HostItem *>::ConstIterator it;
         for (it = m_hostItems.constBegin(); it != m_hostItems.constEnd(); ++it) {
+            delete (*it)->stateItem();
             delete *it;
         }
 
@@ -516,7 +556,7 @@ void StarView::updateSchedulerState(Monitor::SchedulerState state)
         mJobMap.clear();
     }
 
-    m_widget->arrangeItems();
+    m_widget->arrangeSchedulerItem();
 }
 
 QWidget *StarView::widget() const
@@ -531,7 +571,11 @@ StarViewGraphicsView::StarViewGraphicsView(QGraphicsScene *scene, StarView *star
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-    scene->setSceneRect(0, 0, width(), height());
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+
+    // Items move and change size all the time, a BSP index costs more than it saves
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
 
     // add scheduler item
     m_schedulerItem = new HostItem(QString());
@@ -539,15 +583,60 @@ StarViewGraphicsView::StarViewGraphicsView(QGraphicsScene *scene, StarView *star
     m_schedulerItem->setZValue(150);
     m_schedulerItem->show();
     arrangeSchedulerItem();
+
+    // Edge changes of all job updates within one frame are applied together
+    m_nodeStatusCallback = FrameScheduler::instance()->addCallback(this, [this]() { drawNodeStatus(); }, 0, false);
 }
 
 void StarViewGraphicsView::resizeEvent(QResizeEvent *)
 {
-    scene()->setSceneRect(0, 0, width(), height());
+    // The layout uses fixed scene coordinates, resizing only changes the zoom
+    fitScene();
+}
 
-    arrangeSchedulerItem();
-    arrangeHostItems();
-    drawNodeStatus();
+void StarViewGraphicsView::wheelEvent(QWheelEvent *e)
+{
+    const qreal current = transform().m11();
+    const qreal zoom = qBound(MinZoom, current * std::pow(1.0015, e->angleDelta().y()), MaxZoom);
+    if (!qFuzzyCompare(zoom, current)) {
+        m_autoFit = false;
+        scale(zoom / current, zoom / current);
+        updateLevelOfDetail();
+    }
+    e->accept();
+}
+
+void StarViewGraphicsView::mouseDoubleClickEvent(QMouseEvent *e)
+{
+    // Back to showing the whole cluster
+    m_autoFit = true;
+    fitScene();
+
+    QGraphicsView::mouseDoubleClickEvent(e);
+}
+
+void StarViewGraphicsView::fitScene()
+{
+    if (m_autoFit) {
+        fitInView(sceneRect(), Qt::KeepAspectRatio);
+        updateLevelOfDetail();
+    }
+}
+
+void StarViewGraphicsView::updateLevelOfDetail()
+{
+    const qreal zoom = transform().m11();
+    const HostItem::LevelOfDetail level = zoom < DotZoomLimit ? HostItem::DotDetail
+                                        : zoom < LabelZoomLimit ? HostItem::LabelDetail
+                                        : HostItem::FullDetail;
+    if (level == m_levelOfDetail) {
+        return;
+    }
+
+    m_levelOfDetail = level;
+    for (auto it = m_hostSlots.constBegin(); it != m_hostSlots.constEnd(); ++it) {
+        it.key()->setLevelOfDetail(level);
+    }
 }
 
 bool StarViewGraphicsView::event(QEvent *e)
@@ -594,11 +683,14 @@ void StarViewGraphicsView::arrangeSchedulerItem()
     const Monitor *monitor = m_starView->monitor();
     const bool isOnline = (monitor ? monitor->schedulerState() == Monitor::Online : false);
     m_schedulerItem->setFixedText(isOnline ? tr("Scheduler") : QStringLiteral("<b>No scheduler available</b>"));
-    m_schedulerItem->setCenterPos(width() / 2, height() / 2);
+    m_schedulerItem->setCenterPos(0, 0);
 }
 
 void StarView::slotConfigChanged()
 {
+    mNodesPerRing = mConfigDialog->nodesPerRing();
+    mArchFilter = mConfigDialog->archFilter();
+
     if (!hostInfoManager()) {
         return;
     }
@@ -613,50 +705,106 @@ void StarView::slotConfigChanged()
         }
     }
 
+    // The domain name setting may have changed
+    for (HostItem *item : std::as_const(m_hostItems)) {
+        item->updateName();
+    }
+
     m_widget->arrangeItems();
 }
 
 void StarViewGraphicsView::arrangeItems()
 {
-    arrangeHostItems();
+    // Slot positions only depend on the number of nodes per ring
+    const int nodesPerRing = qMax(1, m_starView->nodesPerRing());
+    if (nodesPerRing != m_layoutNodesPerRing) {
+        m_layoutNodesPerRing = nodesPerRing;
+        m_slotPositions.clear();
+
+        for (auto it = m_hostSlots.constBegin(); it != m_hostSlots.constEnd(); ++it) {
+            const QPointF pos = slotPosition(it.value());
+            it.key()->setCenterPos(pos.x(), pos.y());
+        }
+    }
+
+    updateSceneRect(true);
     arrangeSchedulerItem();
+    scheduleAllNodeStatus();
 }
 
-void StarViewGraphicsView::arrangeHostItems()
+QPointF StarViewGraphicsView::slotPosition(int slot)
 {
-//  qDebug() << "StarView::arrangeHostItems()" << endl;
-
-    const QList<HostItem *> hostItems = m_starView->hostItems();
-    int count = hostItems.count();
+    if (m_layoutNodesPerRing == 0) {
+        m_layoutNodesPerRing = qMax(1, m_starView->nodesPerRing());
+    }
 
-//  qDebug() << "  Count: " << count << endl;
+    // Rings of nodesPerRing slots each, every second ring rotated by half a slot
+    const double innerRadius = qMax(MinRadius, m_layoutNodesPerRing * SlotSpacing / (2 * M_PI));
+    while (m_slotPositions.size() <= slot) {
+        const int index = m_slotPositions.size();
+        const int ring = index / m_layoutNodesPerRing;
+        const double radius = innerRadius + ring * RingSpacing;
+        const double angle = 2 * M_PI * ((index % m_layoutNodesPerRing) + (ring % 2) * 0.5) / m_layoutNodesPerRing;
+        m_slotPositions.append(QPointF(cos(angle) * radius, sin(angle) * radius));
+    }
+    return m_slotPositions.at(slot);
+}
 
-    int nodesPerRing = m_starView->configDialog()->nodesPerRing();
+void StarViewGraphicsView::updateSceneRect(bool force)
+{
+    const int nodesPerRing = qMax(1, m_layoutNodesPerRing);
+    const int ringCount = qMax(1, (m_slotCount + nodesPerRing - 1) / nodesPerRing);
+    if (ringCount == m_ringCount && !force) {
+        return;
+    }
 
-    int ringCount = int( count / nodesPerRing ) + 1;
+    m_ringCount = ringCount;
+    const double innerRadius = qMax(MinRadius, nodesPerRing * SlotSpacing / (2 * M_PI));
+    const double radius = innerRadius + (ringCount - 1) * RingSpacing + SlotSpacing;
+    scene()->setSceneRect(-radius, -radius, 2 * radius, 2 * radius);
+    fitScene();
+}
 
-//  qDebug() << "  Rings: " << ringCount << endl;
-    const double radiusFactor = 3.0;
-    const int xRadius = qRound(scene()->width() / radiusFactor);
-    const int yRadius = qRound(scene()->height() / radiusFactor);
+void StarViewGraphicsView::addHostItem(HostItem *item)
+{
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        std::pop_heap(m_freeSlots.begin(), m_freeSlots.end(), std::greater<int>());
+        slot = m_freeSlots.takeLast();
+    } else {
+        slot = m_slotCount++;
+    }
+    m_hostSlots.insert(item, slot);
 
-    const double step = 2 * M_PI / count;
+    item->updateName();
+    const QPointF pos = slotPosition(slot);
+    item->setCenterPos(pos.x(), pos.y());
+    item->setLevelOfDetail(m_levelOfDetail);
 
-    double angle = 0.0;
-    int i = 0;
-    foreach(HostItem * item, hostItems) {
-        double factor = 1 - (1.0 / (ringCount + 1)) * (i % ringCount);
+    updateSceneRect();
+}
 
-        double xr = xRadius * factor;
-        double yr = yRadius * factor;
+void StarViewGraphicsView::removeHostItem(HostItem *item)
+{
+    const auto it = m_hostSlots.constFind(item);
+    if (it == m_hostSlots.constEnd()) {
+        return;
+    }
 
-        item->updateName();
-        item->setCenterPos(width() / 2 + cos(angle) * xr,
-                           height() / 2 + sin(angle) * yr);
+    // Other hosts stay where they are, the slot is reused by the next new host
+    m_freeSlots.append(it.value());
+    std::push_heap(m_freeSlots.begin(), m_freeSlots.end(), std::greater<int>());
+    m_hostSlots.erase(it);
+    forgetNode(item);
+}
 
-        angle += step;
-        ++i;
-    }
+void StarViewGraphicsView::clearHostItems()
+{
+    m_hostSlots.clear();
+    m_freeSlots.clear();
+    m_dirtyNodes.clear();
+    m_slotCount = 0;
+    updateSceneRect();
 }
 
 HostItem *StarView::createHostItem(unsigned int hostid)
@@ -675,47 +823,77 @@ HostItem *StarView::createHostItem(unsigned int hostid)
     m_canvas->addItem(hostItem);
     hostItem->setHostColor(hostColor(hostid));
     m_hostItems.insert(hostid, hostItem);
+    m_widget->addHostItem(hostItem);
     hostItem->show();
 
-    if (m_hostItems.count() > 25) {
+    if (mConfigDialog && m_hostItems.count() > 25) {
         mConfigDialog->setMaxNodes(m_hostItems.count());
     }
 
     return hostItem;
 }
 
-void StarViewGraphicsView::drawNodeStatus()
+void StarViewGraphicsView::scheduleNodeStatus(HostItem *node)
+{
+    m_dirtyNodes.insert(node);
+    FrameScheduler::instance()->setCallbackEnabled(m_nodeStatusCallback, true);
+}
+
+void StarViewGraphicsView::scheduleAllNodeStatus()
 {
     const QList<HostItem *> hostItems = m_starView->hostItems();
-    foreach(HostItem * item, hostItems) {
+    for (HostItem *item : hostItems) {
+        scheduleNodeStatus(item);
+    }
+}
+
+void StarViewGraphicsView::forgetNode(HostItem *node)
+{
+    m_dirtyNodes.remove(node);
+}
+
+void StarViewGraphicsView::drawNodeStatus()
+{
+    for (HostItem *item : std::as_const(m_dirtyNodes)) {
         drawState(item);
     }
+    m_dirtyNodes.clear();
+    FrameScheduler::instance()->setCallbackEnabled(m_nodeStatusCallback, false);
 }
 
 void StarViewGraphicsView::drawState(HostItem *node)
 {
-    delete node->stateItem();
-    QGraphicsLineItem *newItem = nullptr;
+    QGraphicsLineItem *edge = node->stateItem();
+
+    if (!node->isCompiling() && !node->isActiveClient()) {
+        if (edge) {
+            edge->hide();
+        }
+        return;
+    }
+
+    if (!edge) {
+        edge = new QGraphicsLineItem;
+        scene()->addItem(edge);
+        node->setStateItem(edge);
+    }
 
     unsigned int client = node->client();
     QColor color = client ? m_starView->hostColor(client) : Qt::green;
 
-    if (node->isCompiling() || node->isActiveClient()) {
-        newItem = new QGraphicsLineItem(qRound(node->centerPosX()),
-                                        qRound(node->centerPosY()),
-                                        qRound(m_schedulerItem->centerPosX()),
-                                        qRound(m_schedulerItem->centerPosY()));
-        if (node->isCompiling()) {
-            newItem->setPen(QPen(color, 0));
-            newItem->setZValue(-301);
-        } else if (node->isActiveClient()) {
-            newItem->setPen(QPen(color, 1, Qt::DashLine));
-            newItem->setZValue(-300);
-        }
-        scene()->addItem(newItem);
+    // The setters below are no-ops unless something actually changed
+    edge->setLine(qRound(node->centerPosX()),
+                  qRound(node->centerPosY()),
+                  qRound(m_schedulerItem->centerPosX()),
+                  qRound(m_schedulerItem->centerPosY()));
+    if (node->isCompiling()) {
+        edge->setPen(QPen(color, 0));
+        edge->setZValue(-301);
+    } else {
+        edge->setPen(QPen(color, 1, Qt::DashLine));
+        edge->setZValue(-300);
     }
-
-    node->setStateItem(newItem);
+    edge->show();
 }
 
 void StarView::createKnownHosts()
@@ -733,6 +911,17 @@ void StarView::createKnownHosts()
 
 void StarView::configureView()
 {
+    if (!mConfigDialog) {
+        mConfigDialog = new StarViewConfigDialog(m_widget.data());
+        if (m_hostItems.count() > 25) {
+            mConfigDialog->setMaxNodes(m_hostItems.count());
+        }
+        mConfigDialog->setNodesPerRing(mNodesPerRing);
+        mConfigDialog->setSuppressDomainName(suppressDomain);
+        connect(mConfigDialog, SIGNAL(configChanged()),
+                SLOT(slotConfigChanged()));
+    }
+
     mConfigDialog->show();
     mConfigDialog->raise();
 }
@@ -749,11 +938,11 @@ bool StarView::filterArch(unsigned int hostid)
 
 bool StarView::filterArch(HostInfo *i)
 {
-    if (mConfigDialog->archFilter().isEmpty()) {
+    if (mArchFilter.isEmpty()) {
         return true;
     }
 
-    static QRegularExpression regExp(mConfigDialog->archFilter());
+    static QRegularExpression regExp(mArchFilter);
 
     if (regExp.match(i->platform()).hasMatch()) {
         return true;
@@ -762,7 +951,3 @@ bool StarView::filterArch(HostInfo *i)
     return false;
 }
 
-StarViewConfigDialog *StarView::configDialog() const
-{
-    return mConfigDialog;
-}
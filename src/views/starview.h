@@ -29,6 +29,9 @@
 #include <QLabel>
 #include <QGraphicsEllipseItem>
 #include <QDialog>
+#include <QHash>
+#include <QSet>
+#include <QVarLengthArray>
 
 class HostInfo;
 class StarView;
@@ -71,6 +74,34 @@ private:
     QCheckBox *mSuppressDomainName;
 };
 
+/**
+ * All job halos of one host, painted as concentric rings around its box
+ */
+class HostHaloItem
+    : public QGraphicsItem
+{
+public:
+    explicit HostHaloItem(QGraphicsItem *parent);
+
+    void setBaseRect(const QRectF &rect);
+
+    void addJob(unsigned int jobId, const QColor &color);
+    void removeJob(unsigned int jobId);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    struct Ring
+    {
+        unsigned int jobId;
+        QColor color;
+    };
+
+    QRectF m_baseRect;
+    QVarLengthArray<Ring, 32> m_rings;
+};
+
 class HostItem
     : public QGraphicsItemGroup
 {
@@ -80,6 +111,14 @@ public:
 
     enum { RttiHostItem = 1000 };
 
+    /// What is drawn of a host, depending on the zoom level
+    enum LevelOfDetail
+    {
+        DotDetail,
+        LabelDetail,
+        FullDetail
+    };
+
     explicit HostItem(const QString &text);
     HostItem(HostInfo *hostInfo, HostInfoManager *);
     ~HostItem() override;
@@ -96,8 +135,9 @@ public:
     void setIsCompiling(bool compiling) { mIsCompiling = compiling; }
     bool isCompiling() const { return mIsCompiling; }
 
-    void setStateItem(QGraphicsItem *item) { m_stateItem = item; }
-    QGraphicsItem *stateItem() { return m_stateItem; }
+    /// The edge to the scheduler, kept for the lifetime of the host item
+    void setStateItem(QGraphicsLineItem *item) { m_stateItem = item; }
+    QGraphicsLineItem *stateItem() const { return m_stateItem; }
 
     void setClient(unsigned int client) { m_client = client; }
     unsigned int client() const { return m_client; }
@@ -117,12 +157,9 @@ public:
 
     void setCenterPos(double x, double y);
 
-    void update(const Job &job);
+    void setLevelOfDetail(LevelOfDetail level);
 
-protected:
-    void createJobHalo(const Job &);
-    void deleteJobHalo(const Job &job);
-    void updateHalos();
+    void update(const Job &job);
 
 private:
     HostInfo *mHostInfo;
@@ -131,17 +168,17 @@ private:
     bool mIsActiveClient;
     bool mIsCompiling;
 
-    QGraphicsItem *m_stateItem;
+    QGraphicsLineItem *m_stateItem;
     QGraphicsTextItem *m_textItem;
     QString m_fixedText;
     unsigned int m_client;
 
     qreal mBaseWidth;
     qreal mBaseHeight;
+    QPointF m_center;
 
     QGraphicsEllipseItem *m_boxItem;
-
-    QMap<Job, QGraphicsEllipseItem *> m_jobHalos;
+    HostHaloItem *m_haloItem;
 
     JobList m_jobs;
 };
@@ -155,19 +192,51 @@ public:
     StarViewGraphicsView(QGraphicsScene *scene, StarView *starView, QWidget *parent = nullptr);
 
     void arrangeItems();
-    void drawNodeStatus();
+    void arrangeSchedulerItem();
+
+    /// Places @p item on the lowest free slot, it keeps that slot until removed
+    void addHostItem(HostItem *item);
+    void removeHostItem(HostItem *item);
+    void clearHostItems();
+
+    /// Redraws the edge of @p node with the next frame
+    void scheduleNodeStatus(HostItem *node);
 
 protected:
     void resizeEvent(QResizeEvent *e) override;
+    void wheelEvent(QWheelEvent *e) override;
+    void mouseDoubleClickEvent(QMouseEvent *e) override;
     bool event(QEvent *event) override;
 
+private slots:
+    void drawNodeStatus();
+
 private:
-    void arrangeHostItems();
-    void arrangeSchedulerItem();
+    void scheduleAllNodeStatus();
+    void forgetNode(HostItem *node);
     void drawState(HostItem *node);
 
+    QPointF slotPosition(int slot);
+    void updateSceneRect(bool force = false);
+    void fitScene();
+    void updateLevelOfDetail();
+
     StarView *m_starView;
     HostItem *m_schedulerItem;
+
+    QHash<HostItem *, int> m_hostSlots;
+    QVector<int> m_freeSlots; // min-heap
+    int m_slotCount{0};
+    int m_ringCount{0};
+    int m_layoutNodesPerRing{0};
+    QVector<QPointF> m_slotPositions;
+
+    bool m_autoFit{true};
+    HostItem::LevelOfDetail m_levelOfDetail{HostItem::FullDetail};
+
+    QSet<HostItem *> m_dirtyNodes;
+    /// Frame scheduler callback of drawNodeStatus(), while nodes are dirty
+    int m_nodeStatusCallback;
 };
 
 class StarView
@@ -199,7 +268,7 @@ public:
 
     bool isConfigurable() override { return true; }
 
-    StarViewConfigDialog *configDialog() const;
+    int nodesPerRing() const { return mNodesPerRing; }
 
     /**
        Return true if node should be shown and false if not.
@@ -219,7 +288,10 @@ private:
 
     QGraphicsScene *m_canvas;
     QScopedPointer<StarViewGraphicsView> m_widget;
-    StarViewConfigDialog *mConfigDialog;
+    /// Created when the view is configured for the first time
+    StarViewConfigDialog *mConfigDialog{nullptr};
+    int mNodesPerRing{25};
+    QString mArchFilter;
 
     QMap<unsigned int, HostItem *> m_hostItems;
     QMap<unsigned int, HostItem *> mJobMap;
@@ -25,239 +25,425 @@
 
 #include <qdebug.h>
 
-#include <qlabel.h>
-#include <qlayout.h>
 #include <qpainter.h>
-#include <QScrollBar>
+#include <QAbstractScrollArea>
 #include <QApplication>
+#include <QHash>
+#include <QHelpEvent>
+#include <QScrollBar>
+#include <QToolTip>
 
-class NodeInfoFrame
-    : public QFrame
-{
-public:
-    NodeInfoFrame(QWidget *parent, const QColor &frameColor)
-        : QFrame(parent)
-        , m_frameColor(frameColor)
-    {
-        setObjectName(QStringLiteral("nodeInfoFrame"));
-        setStyleSheet(QStringLiteral("QFrame#nodeInfoFrame { border: 2px solid %1 }").arg(frameColor.name()));
-    }
-private:
-    QColor m_frameColor;
-};
+#include <algorithm>
 
-class SummaryViewScrollArea
-    : public QScrollArea
+/**
+ * Paints the summary of all hosts, one row per host
+ *
+ * Only the rows intersecting the viewport are painted. The job slots of a
+ * host are plain data, jobs are mapped to their slot by id.
+ */
+class SummaryViewCanvas
+    : public QAbstractScrollArea
 {
 public:
-    explicit SummaryViewScrollArea(QWidget *parent = nullptr);
+    explicit SummaryViewCanvas(QWidget *parent = nullptr);
+
+    void clear();
+    bool hasHost(unsigned int hostId) const { return m_hostIndex.contains(hostId); }
+    void addHost(unsigned int hostId, const QString &name, const QColor &color, int maxJobs);
+    void removeHost(unsigned int hostId);
 
+    void startJob(const Job &job, const QString &source, const QColor &color);
+    void finishJob(const Job &job);
+    void finishClientJob(const Job &job);
+
+protected:
+    void paintEvent(QPaintEvent *) override;
     void resizeEvent(QResizeEvent *) override;
+    bool viewportEvent(QEvent *e) override;
+
+private:
+    struct Slot
+    {
+        bool busy{false};
+        unsigned int jobId{0};
+        QColor color;
+        QString source;
+        QString state;
+    };
+
+    struct Host
+    {
+        unsigned int hostId;
+        QString name;
+        QColor color;
+        QVector<Slot> slots;
+
+        int jobCount{0};
+        double totalJobsLength{0.0};
+        int finishedJobCount{0};
+
+        double totalRequestedJobsLength{0.0};
+        int requestedJobCount{0};
+
+        int top{0};
+        int height{0};
+    };
+
+    struct JobSlot
+    {
+        unsigned int hostId;
+        int slot;
+    };
+
+    static const int Margin = 5;
+    static const int Padding = 10;
+    static const int Spacing = 5;
+    static const int BarHeight = 15;
+    static const int SlotSpacing = 8;
+
+    int rowHeight(int maxJobs) const;
+    void relayout(int first);
+    void updateScrollBar();
+    void updateRow(int index);
+    int rowAt(int y) const;
+
+    QRect labelBoxRect(const Host &host) const;
+    QRect detailsBoxRect(const Host &host) const;
+    void paintHost(QPainter *p, const Host &host) const;
+
+    static QString jobsText(const Host &host);
+    static QString speedText(const Host &host);
+
+    QVector<Host> m_hosts;
+    QHash<unsigned int, int> m_hostIndex;
+    QHash<unsigned int, JobSlot> m_jobSlots;
+
+    int m_contentHeight{0};
+    int m_labelBoxWidth{75};
+    int m_captionWidth{0};
 };
 
 ////////////////////////////////////////////////////////////////////////////////
-// SummaryViewItem implementation
+// SummaryViewCanvas implementation
 ////////////////////////////////////////////////////////////////////////////////
 
-SummaryViewItem::SummaryViewItem(unsigned int hostid, QWidget *parent, SummaryView *view, QGridLayout *layout)
-    : m_view(view)
+SummaryViewCanvas::SummaryViewCanvas(QWidget *parent)
+    : QAbstractScrollArea(parent)
 {
-    const int row = layout->rowCount();
-    const QColor nodeColor = view->hostInfoManager()->hostColor(hostid);
-
-    auto labelBox = new NodeInfoFrame(parent, nodeColor);
-    layout->setContentsMargins({5, 5, 5, 5});
-    layout->addWidget(labelBox, row, 0);
-    labelBox->show();
-    labelBox->setMinimumWidth(75);
-    m_widgets.append(labelBox);
-
-    auto labelLayout = new QVBoxLayout(labelBox);
-    labelLayout->setContentsMargins({10, 10, 10, 10});
-    labelLayout->setSpacing(5);
-
-    QLabel *l;
-
-    l = new QLabel(view->nameForHost(hostid), labelBox);
-    l->setAlignment(Qt::AlignCenter);
-    l->show();
-    labelLayout->addWidget(l);
-
-    m_speedLabel = new QLabel(labelBox);
-    m_speedLabel->setToolTip(QApplication::tr("Average job time for a file sent by this client / total number of jobs sent."));
-    m_speedLabel->setAlignment(Qt::AlignCenter);
-    m_speedLabel->show();
-    labelLayout->addWidget(m_speedLabel);
-
-    const int maxJobs = view->hostInfoManager()->maxJobs(hostid);
-
-    m_jobHandlers.resize(maxJobs);
-
-    for (int i = 0; i < maxJobs; i++) {
-        m_jobHandlers[i].stateWidget = new QFrame(labelBox);
-        m_jobHandlers[i].stateWidget->setFrameStyle(QFrame::Box | QFrame::Plain);
-        m_jobHandlers[i].stateWidget->setLineWidth(2);
-        m_jobHandlers[i].stateWidget->setFixedHeight(15);
-        QPalette palette = m_jobHandlers[i].stateWidget->palette();
-        palette.setColor(m_jobHandlers[i].stateWidget->foregroundRole(), Qt::black);
-        m_jobHandlers[i].stateWidget->setPalette(palette);
-        m_jobHandlers[i].stateWidget->show();
-        labelLayout->addWidget(m_jobHandlers[i].stateWidget);
+    viewport()->setBackgroundRole(QPalette::Window);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(20);
+
+    const QFontMetrics fm = fontMetrics();
+    for (const QString &caption : {QApplication::tr("Jobs:"), QApplication::tr("Source:"), QApplication::tr("State:")}) {
+        m_captionWidth = qMax(m_captionWidth, fm.horizontalAdvance(caption));
     }
 
-    auto detailsBox = new NodeInfoFrame(parent, nodeColor);
-    layout->setContentsMargins({5, 5, 5, 5});
-    layout->addWidget(detailsBox, row, 1);
-    detailsBox->show();
-    m_widgets.append(detailsBox);
+    // Wide enough for the statistics of busy clients
+    const QStringList speedLines = QApplication::tr("Ø job time: %1 ms\nrequested jobs count: %2").arg(
+        QStringLiteral("99999"), QStringLiteral("99999")).split(QLatin1Char('\n'));
+    for (const QString &line : speedLines) {
+        m_labelBoxWidth = qMax(m_labelBoxWidth, fm.horizontalAdvance(line) + 2 * Padding);
+    }
+}
 
-    auto grid = new QGridLayout(detailsBox);
-    grid->setContentsMargins({10, 10, 10, 10});
-    grid->setSpacing(5);
+void SummaryViewCanvas::clear()
+{
+    m_hosts.clear();
+    m_hostIndex.clear();
+    m_jobSlots.clear();
+    relayout(0);
+}
 
-    m_jobsLabel = addLine(QApplication::tr("Jobs:"), detailsBox, grid, Qt::AlignBottom, QStringLiteral("0"));
-    m_jobsLabel->setToolTip(QApplication::tr("Total number of jobs processed by this server / average duration of each job."));
+void SummaryViewCanvas::addHost(unsigned int hostId, const QString &name, const QColor &color, int maxJobs)
+{
+    Host host;
+    host.hostId = hostId;
+    host.name = name;
+    host.color = color;
+    host.slots.resize(maxJobs);
+    host.height = rowHeight(maxJobs);
+
+    m_labelBoxWidth = qMax(m_labelBoxWidth, fontMetrics().horizontalAdvance(name) + 2 * Padding);
+
+    m_hostIndex.insert(hostId, m_hosts.size());
+    m_hosts.append(host);
+    relayout(m_hosts.size() - 1);
+}
+
+void SummaryViewCanvas::removeHost(unsigned int hostId)
+{
+    const int index = m_hostIndex.value(hostId, -1);
+    if (index < 0) {
+        return;
+    }
 
-    for (int i = 0; i < maxJobs; i++) {
-        if (maxJobs > 1) {
-            auto spacer  = new QSpacerItem(1, 8, QSizePolicy::Expanding);
-            const int row = grid->rowCount();
-            grid->addItem(spacer, row, 0, 1, grid->columnCount() - 1);
+    for (const Slot &slot : std::as_const(m_hosts.at(index).slots)) {
+        if (slot.busy) {
+            m_jobSlots.remove(slot.jobId);
         }
-        m_jobHandlers[i].sourceLabel = addLine(QApplication::tr("Source:"), detailsBox, grid);
-        m_jobHandlers[i].stateLabel = addLine(QApplication::tr("State:"), detailsBox, grid);
     }
 
-    grid->setColumnStretch(grid->columnCount() - 1, 1);
-    grid->setRowStretch(0, 1);
-    grid->setRowStretch(grid->rowCount(), 1);
+    m_hostIndex.remove(hostId);
+    m_hosts.remove(index);
+    for (int i = index; i < m_hosts.size(); ++i) {
+        m_hostIndex.insert(m_hosts.at(i).hostId, i);
+    }
+    relayout(index);
 }
 
-SummaryViewItem::~SummaryViewItem()
+void SummaryViewCanvas::startJob(const Job &job, const QString &source, const QColor &color)
 {
-    qDeleteAll(m_widgets);
-    m_widgets.clear();
-}
+    const int index = m_hostIndex.value(job.server, -1);
+    if (index < 0) {
+        return;
+    }
 
-void SummaryViewItem::updateStats()
-{
-    const double avgDuration = m_finishedJobCount > 0 ? m_totalJobsLength / m_finishedJobCount : 0.0f;
-    m_jobsLabel->setText(QApplication::tr("%1 (Ø duration: %2 ms)").arg(
-        QString::number(m_jobCount),
-        QString::number(avgDuration, 'f', 0)
-    ));
+    Host &host = m_hosts[index];
+    host.jobCount++;
 
-    const double avgTime = m_requestedJobCount > 0 ? m_totalRequestedJobsLength / m_requestedJobCount : 0.0f;
-    if (qIsNull(avgTime)) {
-        m_speedLabel->setText(QString());
+    int slot = -1;
+    const auto it = m_jobSlots.constFind(job.id);
+    if (it != m_jobSlots.constEnd()) {
+        slot = it->slot;
     } else {
-        m_speedLabel->setText(QApplication::tr("Ø job time: %1 ms\nrequested jobs count: %2").arg(
-            QString::number(avgTime, 'f', 0),
-            QString::number(m_requestedJobCount)
-        ));
+        for (int i = 0; i < host.slots.size(); ++i) {
+            if (!host.slots.at(i).busy) {
+                slot = i;
+                break;
+            }
+        }
+    }
+
+    if (slot >= 0) {
+        Slot &s = host.slots[slot];
+        s.busy = true;
+        s.jobId = job.id;
+        s.color = color;
+        s.source = source;
+        s.state = job.stateAsString();
+        m_jobSlots.insert(job.id, {job.server, slot});
     }
+
+    updateRow(index);
 }
 
-void SummaryViewItem::updateClient(const Job &job)
+void SummaryViewCanvas::finishJob(const Job &job)
 {
+    const auto it = m_jobSlots.find(job.id);
+    if (it == m_jobSlots.end()) {
+        return;
+    }
+
+    const int index = m_hostIndex.value(it->hostId);
+    Host &host = m_hosts[index];
+    Slot &s = host.slots[it->slot];
+    s.busy = false;
+    s.color = QColor();
+    s.source.clear();
+    s.state = job.stateAsString();
+    m_jobSlots.erase(it);
+
     if (job.state == Job::Finished) {
-	m_totalRequestedJobsLength += job.real_msec;
-	m_requestedJobCount++;
-	updateStats();
+        host.totalJobsLength += job.real_msec;
+        host.finishedJobCount++;
     }
+
+    updateRow(index);
 }
 
-void SummaryViewItem::update(const Job &job)
+void SummaryViewCanvas::finishClientJob(const Job &job)
 {
-    switch (job.state) {
-    case Job::Compiling:
-    {
-        m_jobCount++;
-        updateStats();
-
-        QVector<JobHandler>::Iterator it = m_jobHandlers.begin();
-        while (it != m_jobHandlers.end() && !(*it).currentFile.isNull())
-            ++it;
-
-        if (it != m_jobHandlers.end()) {
-            const QColor nodeColor = m_view->hostInfoManager()->hostColor(job.client);
-            QPalette palette = (*it).stateWidget->palette();
-            palette.setColor((*it).stateWidget->foregroundRole(), nodeColor);
-            (*it).stateWidget->setPalette(palette);
-            const QString fileName = job.fileName.section(QLatin1Char('/'), -1);
-            const QString hostName = m_view->nameForHost(job.client);
-            (*it).sourceLabel->setText(QStringLiteral("%1 (%2)").arg(fileName).arg(hostName));
-            (*it).stateLabel->setText(job.stateAsString());
-            (*it).currentFile = job.fileName;
-        }
-        break;
+    const int index = m_hostIndex.value(job.client, -1);
+    if (index < 0) {
+        return;
     }
-    case Job::Finished:
-    case Job::Failed:
-    {
-        QVector<JobHandler>::Iterator it = m_jobHandlers.begin();
-        while (it != m_jobHandlers.end() && (*it).currentFile != job.fileName)
-            ++it;
-
-        if (it != m_jobHandlers.end()) {
-            QPalette palette = (*it).stateWidget->palette();
-            palette.setColor((*it).stateWidget->foregroundRole(), Qt::black);
-            (*it).stateWidget->setPalette(palette);
-	    (*it).stateWidget->repaint();
-            (*it).sourceLabel->clear();
-            (*it).stateLabel->setText(job.stateAsString());
-            (*it).currentFile = QString();
-	    if (job.state == Job::Finished) {
-	      m_totalJobsLength += job.real_msec;
-	      m_finishedJobCount++;
-	      updateStats();
-	    }
-        }
-        break;
+
+    Host &host = m_hosts[index];
+    host.totalRequestedJobsLength += job.real_msec;
+    host.requestedJobCount++;
+
+    updateRow(index);
+}
+
+int SummaryViewCanvas::rowHeight(int maxJobs) const
+{
+    const int line = fontMetrics().lineSpacing();
+
+    // name, two lines of statistics and a bar per job slot
+    const int labelBox = 2 * Padding + 3 * line + maxJobs * (BarHeight + Spacing);
+    // job count and two lines per job slot
+    const int detailsBox = 2 * Padding + line + maxJobs * (SlotSpacing + 2 * line + Spacing);
+
+    return qMax(labelBox, detailsBox);
+}
+
+void SummaryViewCanvas::relayout(int first)
+{
+    int top = first > 0 ? m_hosts.at(first - 1).top + m_hosts.at(first - 1).height + Spacing : Margin;
+    for (int i = first; i < m_hosts.size(); ++i) {
+        m_hosts[i].top = top;
+        top += m_hosts.at(i).height + Spacing;
     }
-    default:
-        break;
+    m_contentHeight = top - Spacing + Margin;
+
+    updateScrollBar();
+    viewport()->update();
+}
+
+void SummaryViewCanvas::updateScrollBar()
+{
+    const int height = viewport()->height();
+    verticalScrollBar()->setPageStep(height);
+    verticalScrollBar()->setRange(0, qMax(0, m_contentHeight - height));
+}
+
+void SummaryViewCanvas::updateRow(int index)
+{
+    const Host &host = m_hosts.at(index);
+    const QRect rect(0, host.top - verticalScrollBar()->value(), viewport()->width(), host.height);
+    if (rect.intersects(viewport()->rect())) {
+        viewport()->update(rect);
     }
 }
 
-QLabel *SummaryViewItem::addLine(const QString &caption, QWidget *parent,
-                                 QGridLayout *grid, Qt::Alignment flags,
-                                 const QString &status)
+int SummaryViewCanvas::rowAt(int y) const
 {
-    auto label = new QLabel(caption, parent);
-    label->setAlignment(Qt::AlignRight | flags);
-    const int row = grid->rowCount();
-    grid->addWidget(label, row, 0);
-    auto statusLabel = new QLabel(status, parent);
-    //statusLabel->setAlignment(Qt::AlignLeft | flags);
-    grid->addWidget(statusLabel, row, 1);
-    label->show();
-    statusLabel->show();
-
-    return statusLabel;
+    // First row whose bottom is below y
+    const auto it = std::lower_bound(m_hosts.constBegin(), m_hosts.constEnd(), y,
+                                     [](const Host &host, int value) { return host.top + host.height <= value; });
+    return int(it - m_hosts.constBegin());
 }
 
-SummaryViewScrollArea::SummaryViewScrollArea(QWidget *parent)
-    : QScrollArea(parent)
+QRect SummaryViewCanvas::labelBoxRect(const Host &host) const
 {
+    return QRect(Margin, host.top, m_labelBoxWidth, host.height);
 }
 
-void SummaryViewScrollArea::resizeEvent(QResizeEvent *e)
+QRect SummaryViewCanvas::detailsBoxRect(const Host &host) const
 {
-    Q_ASSERT(widget());
+    const int left = Margin + m_labelBoxWidth + Spacing;
+    return QRect(left, host.top, qMax(0, viewport()->width() - left - Margin), host.height);
+}
 
-    QSize s = e->size();
+QString SummaryViewCanvas::jobsText(const Host &host)
+{
+    const double avgDuration = host.finishedJobCount > 0 ? host.totalJobsLength / host.finishedJobCount : 0.0;
+    return QApplication::tr("%1 (Ø duration: %2 ms)").arg(
+        QString::number(host.jobCount),
+        QString::number(avgDuration, 'f', 0)
+    );
+}
 
-    setMinimumWidth(widget()->minimumSizeHint().width() + verticalScrollBar()->width());
-    widget()->setMinimumWidth(s.width());
+QString SummaryViewCanvas::speedText(const Host &host)
+{
+    const double avgTime = host.requestedJobCount > 0 ? host.totalRequestedJobsLength / host.requestedJobCount : 0.0;
+    if (qIsNull(avgTime)) {
+        return QString();
+    }
+    return QApplication::tr("Ø job time: %1 ms\nrequested jobs count: %2").arg(
+        QString::number(avgTime, 'f', 0),
+        QString::number(host.requestedJobCount)
+    );
+}
 
-    if (widget()->height() <= s.height()) {
-        widget()->setMinimumHeight(s.height());
-    } else {
-        widget()->setMinimumHeight(widget()->sizeHint().height());
+void SummaryViewCanvas::paintHost(QPainter *p, const Host &host) const
+{
+    const int line = fontMetrics().lineSpacing();
+    const QColor textColor = palette().color(QPalette::WindowText);
+    const QPen framePen(host.color, 2);
+
+    // Host name, client statistics and one bar per job slot
+    QRect box = labelBoxRect(host);
+    p->setPen(framePen);
+    p->drawRect(box.adjusted(1, 1, -1, -1));
+
+    QRect content = box.adjusted(Padding, Padding, -Padding, -Padding);
+    p->setPen(textColor);
+    p->drawText(QRect(content.x(), content.y(), content.width(), line), Qt::AlignCenter, host.name);
+    p->drawText(QRect(content.x(), content.y() + line, content.width(), 2 * line), Qt::AlignCenter, speedText(host));
+
+    int y = content.y() + 3 * line;
+    for (const Slot &slot : host.slots) {
+        p->setPen(QPen(slot.busy ? slot.color : QColor(Qt::black), 2));
+        p->drawRect(QRect(content.x(), y, content.width(), BarHeight).adjusted(1, 1, -1, -1));
+        y += BarHeight + Spacing;
+    }
+
+    // Server statistics and the jobs currently running
+    box = detailsBoxRect(host);
+    p->setPen(framePen);
+    p->drawRect(box.adjusted(1, 1, -1, -1));
+
+    content = box.adjusted(Padding, Padding, -Padding, -Padding);
+    const int valueX = content.x() + m_captionWidth + Spacing;
+    const int valueWidth = qMax(0, content.right() - valueX);
+    const auto drawLine = [&](int y, const QString &caption, const QString &value) {
+        p->drawText(QRect(content.x(), y, m_captionWidth, line), Qt::AlignRight | Qt::AlignVCenter, caption);
+        p->drawText(QRect(valueX, y, valueWidth, line), Qt::AlignLeft | Qt::AlignVCenter,
+                    fontMetrics().elidedText(value, Qt::ElideRight, valueWidth));
+    };
+
+    p->setPen(textColor);
+    y = content.y();
+    drawLine(y, QApplication::tr("Jobs:"), jobsText(host));
+    y += line;
+    for (const Slot &slot : host.slots) {
+        if (host.slots.size() > 1) {
+            y += SlotSpacing;
+        }
+        drawLine(y, QApplication::tr("Source:"), slot.source);
+        drawLine(y + line, QApplication::tr("State:"), slot.state);
+        y += 2 * line + Spacing;
+    }
+}
+
+void SummaryViewCanvas::paintEvent(QPaintEvent *e)
+{
+    QPainter p(viewport());
+
+    const int offset = verticalScrollBar()->value();
+    p.translate(0, -offset);
+
+    const QRect exposed = e->rect().translated(0, offset);
+    for (int i = rowAt(exposed.top()); i < m_hosts.size(); ++i) {
+        const Host &host = m_hosts.at(i);
+        if (host.top > exposed.bottom()) {
+            break;
+        }
+        paintHost(&p, host);
+    }
+}
+
+void SummaryViewCanvas::resizeEvent(QResizeEvent *e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    updateScrollBar();
+}
+
+bool SummaryViewCanvas::viewportEvent(QEvent *e)
+{
+    if (e->type() != QEvent::ToolTip) {
+        return QAbstractScrollArea::viewportEvent(e);
+    }
+
+    const auto *helpEvent = static_cast<QHelpEvent *>(e);
+    const QPoint pos = helpEvent->pos() + QPoint(0, verticalScrollBar()->value());
+    const int index = rowAt(pos.y());
+    if (index < m_hosts.size() && m_hosts.at(index).top <= pos.y()) {
+        const Host &host = m_hosts.at(index);
+        if (labelBoxRect(host).contains(pos)) {
+            QToolTip::showText(helpEvent->globalPos(), QApplication::tr("Average job time for a file sent by this client / total number of jobs sent."), viewport());
+            return true;
+        } else if (detailsBoxRect(host).contains(pos)) {
+            QToolTip::showText(helpEvent->globalPos(), QApplication::tr("Total number of jobs processed by this server / average duration of each job."), viewport());
+            return true;
+        }
     }
 
-    QScrollArea::resizeEvent(e);
+    QToolTip::hideText();
+    e->ignore();
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -266,17 +452,8 @@ void SummaryViewScrollArea::resizeEvent(QResizeEvent *e)
 
 SummaryView::SummaryView(QObject *parent)
     : StatusView(parent)
-    , m_widget(new SummaryViewScrollArea)
+    , m_widget(new SummaryViewCanvas)
 {
-    m_base = new QWidget;
-    m_widget->setWidget(m_base);
-
-    m_layout = new QGridLayout(m_base);
-    m_layout->setColumnStretch(1, 1);
-    m_layout->setSpacing(5);
-    m_layout->setContentsMargins({5, 5, 5, 5});
-
-    m_widget->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_widget->setMinimumHeight(150);
     createKnownHosts();
 }
@@ -295,13 +472,22 @@ void SummaryView::update(const Job &job)
     if (!job.server)
         return;
 
-    SummaryViewItem *i = m_items[job.server];
-    if (i)
-        i->update(job);
+    switch (job.state) {
+    case Job::Compiling:
+        m_widget->startJob(job, QStringLiteral("%1 (%2)").arg(job.fileName.section(QLatin1Char('/'), -1), nameForHost(job.client)),
+                           hostColor(job.client));
+        break;
+    case Job::Finished:
+    case Job::Failed:
+        m_widget->finishJob(job);
+        break;
+    default:
+        break;
+    }
 
-    i= m_items[job.client];
-    if (i)
-	i->updateClient(job);
+    if (job.state == Job::Finished) {
+        m_widget->finishClientJob(job);
+    }
 }
 
 void SummaryView::createKnownHosts()
@@ -310,8 +496,7 @@ void SummaryView::createKnownHosts()
         return;
     }
 
-    qDeleteAll(m_items);
-    m_items.clear();
+    m_widget->clear();
 
     const HostInfoManager::HostMap hosts(hostInfoManager()->hostMap());
 
@@ -333,16 +518,12 @@ void SummaryView::checkNode(unsigned int hostid)
     HostInfo *hostInfo = hostInfoManager()->find(hostid);
 
     if (!hostInfo) {
-        delete m_items[hostid];
-        m_items.remove(hostid);
-    } else if (!m_items[hostid]) {
-        auto i = new SummaryViewItem(hostid, m_base, this, m_layout);
-        m_items.insert(hostid, i);
-	m_widget->widget()->setMinimumHeight(m_widget->widget()->sizeHint().height());
+        m_widget->removeHost(hostid);
+    } else if (!m_widget->hasHost(hostid)) {
+        m_widget->addHost(hostid, nameForHost(hostid), hostColor(hostid), hostInfoManager()->maxJobs(hostid));
     }
 }
 void SummaryView::removeNode(unsigned int hostid)
 {
-        delete m_items[hostid];
-        m_items.remove(hostid);
+        m_widget->removeHost(hostid);
 }
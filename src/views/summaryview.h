@@ -23,52 +23,7 @@
 
 #include "statusview.h"
 
-#include <QScrollArea>
-#include <QResizeEvent>
-
-class QLabel;
-class QGridLayout;
-
-class SummaryView;
-class SummaryViewScrollArea;
-
-class SummaryViewItem
-{
-public:
-    SummaryViewItem(unsigned int hostid, QWidget *parent, SummaryView *view, QGridLayout *layout);
-    ~SummaryViewItem();
-    void update(const Job &job);
-    void updateClient(const Job &job);
-
-private:
-    QLabel *addLine(const QString &caption, QWidget *parent, QGridLayout *grid,
-                    Qt::Alignment flags = Qt::AlignTop,
-                    const QString &status = QString());
-    void updateStats();
-     
-    struct JobHandler
-    {
-        QFrame *stateWidget{nullptr};
-        QLabel *sourceLabel{nullptr};
-        QLabel *stateLabel{nullptr};
-        QString currentFile;
-    };
-
-    QLabel *m_speedLabel;
-    QLabel *m_jobsLabel;
-
-    int m_jobCount{0};
-    double m_totalJobsLength{0.0f};
-    int m_finishedJobCount{0};
-
-    double m_totalRequestedJobsLength{0.0f};
-    int m_requestedJobCount{0};
-
-    SummaryView *m_view;
-
-    QVector<JobHandler> m_jobHandlers;
-    QList<QWidget *> m_widgets;
-};
+class SummaryViewCanvas;
 
 class SummaryView
     : public StatusView
@@ -88,11 +43,7 @@ public:
     QString id() const override { return QStringLiteral("summary"); }
 
 private:
-    QScopedPointer<SummaryViewScrollArea> m_widget;
-
-    QMap<unsigned int, SummaryViewItem *> m_items;
-    QGridLayout *m_layout;
-    QWidget *m_base;
+    QScopedPointer<SummaryViewCanvas> m_widget;
 
     void createKnownHosts();
 };
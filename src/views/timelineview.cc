@@ -0,0 +1,290 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "timelineview.h"
+
+#include "capacityrollups.h"
+#include "framescheduler.h"
+
+#include <QBoxLayout>
+#include <QComboBox>
+#include <QDateTime>
+#include <QLabel>
+#include <QLocale>
+#include <QPainter>
+#include <QPolygonF>
+#include <QSettings>
+#include <QtMath>
+
+namespace {
+
+const int Margin = 6;
+const int LegendBoxSize = 10;
+
+}
+
+/**
+ * Paints the stacked platform bands
+ */
+class TimelineCanvas
+    : public QWidget
+{
+public:
+    struct Band
+    {
+        QString name;
+        QColor color;
+        QVector<CapacityRollups::Sample> samples;
+    };
+
+    explicit TimelineCanvas(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setMinimumHeight(150);
+    }
+
+    void setData(qint64 from, qint64 to, const QVector<Band> &bands)
+    {
+        m_from = from;
+        m_to = to;
+        m_bands = bands;
+        FrameScheduler::instance()->markDirty(this);
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+
+private:
+    qint64 m_from{0};
+    qint64 m_to{1};
+    QVector<Band> m_bands;
+};
+
+void TimelineCanvas::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette().base());
+
+    const QFontMetrics metrics = fontMetrics();
+    const int lineHeight = metrics.height();
+
+    // Legend along the top
+    int x = Margin;
+    for (const Band &band : std::as_const(m_bands)) {
+        p.fillRect(x, Margin + (lineHeight - LegendBoxSize) / 2, LegendBoxSize, LegendBoxSize, band.color);
+        x += LegendBoxSize + Margin;
+        p.setPen(palette().color(QPalette::Text));
+        p.drawText(x, Margin + metrics.ascent(), band.name);
+        x += metrics.horizontalAdvance(band.name) + 2 * Margin;
+    }
+
+    // The samples of all platforms share the same buckets
+    int count = 0;
+    for (const Band &band : std::as_const(m_bands)) {
+        count = qMax(count, band.samples.size());
+    }
+    QVector<double> base(count, 0.0);
+    double maximum = 1.0;
+    for (int i = 0; i < count; ++i) {
+        double total = 0.0;
+        for (const Band &band : std::as_const(m_bands)) {
+            if (i < band.samples.size()) {
+                total += qMax(band.samples.at(i).capacity, band.samples.at(i).active);
+            }
+        }
+        maximum = qMax(maximum, total);
+    }
+
+    const QString maximumText = QLocale().toString(qCeil(maximum));
+    const QRect plot(2 * Margin + metrics.horizontalAdvance(maximumText), 2 * Margin + lineHeight,
+                     width() - 3 * Margin - metrics.horizontalAdvance(maximumText),
+                     height() - 4 * Margin - 2 * lineHeight);
+    if (plot.width() <= 0 || plot.height() <= 0) {
+        return;
+    }
+
+    const double span = qMax<qint64>(1, m_to - m_from);
+    auto xFor = [&](qint64 time) {
+        return plot.left() + (time - m_from) * plot.width() / span;
+    };
+    auto yFor = [&](double value) {
+        return plot.bottom() - value * plot.height() / maximum;
+    };
+
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setClipRect(plot);
+    for (const Band &band : std::as_const(m_bands)) {
+        const QVector<CapacityRollups::Sample> &samples = band.samples;
+        if (samples.isEmpty()) {
+            continue;
+        }
+
+        QPolygonF area;
+        QPolygonF capacity;
+        area.reserve(2 * samples.size());
+        capacity.reserve(samples.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            const double sampleX = xFor(samples.at(i).time);
+            area << QPointF(sampleX, yFor(base.at(i) + samples.at(i).active));
+            capacity << QPointF(sampleX, yFor(base.at(i) + samples.at(i).capacity));
+        }
+        for (int i = samples.size() - 1; i >= 0; --i) {
+            area << QPointF(xFor(samples.at(i).time), yFor(base.at(i)));
+            base[i] += samples.at(i).capacity;
+        }
+
+        QColor fill = band.color;
+        fill.setAlpha(180);
+        p.setPen(Qt::NoPen);
+        p.setBrush(fill);
+        p.drawPolygon(area);
+        p.setPen(QPen(band.color.darker(150), 1.5));
+        p.setBrush(Qt::NoBrush);
+        p.drawPolyline(capacity);
+    }
+    p.setClipping(false);
+    p.setRenderHint(QPainter::Antialiasing, false);
+
+    // Axes
+    p.setPen(palette().color(QPalette::Mid));
+    p.drawRect(plot.adjusted(0, 0, -1, -1));
+    p.setPen(palette().color(QPalette::Text));
+    p.drawText(QRect(Margin, plot.top(), plot.left() - 2 * Margin, lineHeight), Qt::AlignRight, maximumText);
+    p.drawText(QRect(Margin, plot.bottom() - lineHeight, plot.left() - 2 * Margin, lineHeight), Qt::AlignRight, QStringLiteral("0"));
+
+    const QLocale locale;
+    const QRect timeRect(plot.left(), plot.bottom() + Margin, plot.width(), lineHeight);
+    p.drawText(timeRect, Qt::AlignLeft,
+               locale.toString(QDateTime::fromMSecsSinceEpoch(m_from).time(), QLocale::ShortFormat));
+    p.drawText(timeRect, Qt::AlignRight,
+               locale.toString(QDateTime::fromMSecsSinceEpoch(m_to).time(), QLocale::ShortFormat));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// TimelineView implementation
+////////////////////////////////////////////////////////////////////////////////
+
+TimelineView::TimelineView(QObject *parent)
+    : StatusView(parent)
+    , m_widget(new QWidget)
+{
+    auto topLayout = new QVBoxLayout(m_widget.data());
+    topLayout->setContentsMargins({});
+
+    auto spanLayout = new QHBoxLayout;
+    spanLayout->setContentsMargins(Margin, Margin, Margin, 0);
+    spanLayout->addWidget(new QLabel(tr("Show the last"), m_widget.data()));
+    m_spanBox = new QComboBox(m_widget.data());
+    m_spanBox->addItem(tr("15 minutes"), 15);
+    m_spanBox->addItem(tr("hour"), 60);
+    m_spanBox->addItem(tr("2 hours"), 2 * 60);
+    m_spanBox->addItem(tr("6 hours"), 6 * 60);
+    m_spanBox->addItem(tr("12 hours"), 12 * 60);
+    m_spanBox->addItem(tr("24 hours"), 24 * 60);
+    spanLayout->addWidget(m_spanBox);
+    spanLayout->addStretch();
+    topLayout->addLayout(spanLayout);
+
+    m_canvas = new TimelineCanvas(m_widget.data());
+    topLayout->addWidget(m_canvas, 1);
+
+    m_refreshCallback = FrameScheduler::instance()->addCallback(this, [this]() { refresh(); }, 0, false);
+
+    readSettings();
+
+    connect(m_spanBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &TimelineView::spanChanged);
+    spanChanged();
+}
+
+TimelineView::~TimelineView()
+{
+    writeSettings();
+}
+
+void TimelineView::readSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    const int index = m_spanBox->findData(settings.value(QStringLiteral("spanMinutes"), 60).toInt());
+    m_spanBox->setCurrentIndex(qMax(0, index));
+    settings.endGroup();
+}
+
+void TimelineView::writeSettings()
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("view_%1").arg(id()));
+    settings.setValue(QStringLiteral("spanMinutes"), m_spanBox->currentData().toInt());
+    settings.endGroup();
+    settings.sync();
+}
+
+QWidget *TimelineView::widget() const
+{
+    return m_widget.data();
+}
+
+void TimelineView::setMonitor(Monitor *monitor)
+{
+    StatusView::setMonitor(monitor);
+
+    refresh();
+}
+
+void TimelineView::stop()
+{
+    FrameScheduler::instance()->setCallbackEnabled(m_refreshCallback, false);
+}
+
+void TimelineView::start()
+{
+    spanChanged();
+}
+
+void TimelineView::spanChanged()
+{
+    // Refresh once per bucket of the resolution the span is shown in
+    const qint64 span = qint64(m_spanBox->currentData().toInt()) * 60 * 1000;
+    FrameScheduler *scheduler = FrameScheduler::instance();
+    scheduler->setCallbackInterval(m_refreshCallback, CapacityRollups::bucketMsecs(CapacityRollups::resolutionFor(span)));
+    scheduler->setCallbackEnabled(m_refreshCallback, !isPaused());
+    refresh();
+}
+
+void TimelineView::refresh()
+{
+    if (!monitor()) {
+        return;
+    }
+
+    const CapacityRollups *rollups = monitor()->capacityRollups();
+    const qint64 span = qint64(m_spanBox->currentData().toInt()) * 60 * 1000;
+    const CapacityRollups::Resolution resolution = CapacityRollups::resolutionFor(span);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<TimelineCanvas::Band> bands;
+    const QStringList platforms = rollups->platforms();
+    for (int i = 0; i < platforms.size(); ++i) {
+        TimelineCanvas::Band band;
+        band.name = platforms.at(i);
+        band.color = QColor::fromHsv((i * 67 + 200) % 360, 140, 220);
+        band.samples = rollups->samples(band.name, resolution, now - span);
+        bands.append(band);
+    }
+    m_canvas->setData(now - span, now, bands);
+}
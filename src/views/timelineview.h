@@ -0,0 +1,69 @@
+/*
+    This file is part of Icecream.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_TIMELINEVIEW_H
+#define ICEMON_TIMELINEVIEW_H
+
+#include "statusview.h"
+
+#include <QScopedPointer>
+
+class QComboBox;
+class TimelineCanvas;
+
+/**
+ * Active jobs against job slots per platform over the last hours
+ *
+ * Every platform is a band as high as its capacity, stacked on each other,
+ * filled up to its number of active jobs. The data comes from the
+ * capacity rollups of the monitor.
+ */
+class TimelineView
+    : public StatusView
+{
+    Q_OBJECT
+
+public:
+    explicit TimelineView(QObject *parent = nullptr);
+    ~TimelineView() override;
+
+    void readSettings();
+    void writeSettings();
+
+    QWidget *widget() const override;
+    QString id() const override { return QStringLiteral("timeline"); }
+
+    void setMonitor(Monitor *monitor) override;
+
+    bool isPausable() override { return true; }
+    void stop() override;
+    void start() override;
+
+private Q_SLOTS:
+    void refresh();
+    void spanChanged();
+
+private:
+    QScopedPointer<QWidget> m_widget;
+    QComboBox *m_spanBox;
+    TimelineCanvas *m_canvas;
+    /// Frame scheduler callback of refresh()
+    int m_refreshCallback;
+};
+
+#endif // ICEMON_TIMELINEVIEW_H